@@ -81,11 +81,676 @@
 	29.05.25 - Add rgba_swap_ssse3
 	01.07.25 - memcpy_sse2 - handle trailing bytes to avoid 16 byte limitation
 			   Modify CopyPixels and FlipBuffer to test for SSE2 only
+	19.10.26 - Add HashRows for change detection
+			 - Add rgba_downsample_sse2 box filter for 2:1 and 4:1
+			   rgba2rgbaResample, rgba2rgbResample and rgba2bgrResample
+			   use it for exact ratios
+			 - Add rgba_upsample_sse2 pixel replication for integer upscale
+			   used by the resample functions for exact ratios
+			 - Add rgba2rgbaResample and rgba2rgbResample with destination pitch
+			 - Add FillPixels
+			 - Add FormatBytes and format2rgba for 16 bit, half float
+			   and 10 bit formats with a format dispatch table
+			 - CheckSSE - add F16C
+			 - Add SetToneMapping and ToneMap for half float formats
+			 - Add SetColourAdjust and AdjustColour. Colour tables and
+			   matrix applied by the rgba conversion functions
+			 - Add rotate2rgba. 90 and 270 degree rotation by 4x4 pixel
+			   transpose in bands of 4 rows.
+			 - FlipBuffer in place - swap rows 64 bytes at a time in SSE2
+			   registers instead of allocating a row buffer
+			 - RemovePadding - memcpy instead of __movsd for rows
+			   that are not 16 byte aligned
+			 - ClearAlpha - replace alpha of 16 pixels at a time with a mask
+			 - Add rgba2rgbaResample, rgba2rgbResample and format2rgba
+			   for destination rows y0 - y1, so that re-sampling can be
+			   divided into bands of rows
 
 */
 
 #include "SpoutCopy.h"
 
+//
+// Colour adjustment helpers
+//
+
+// Exchange bytes 0 and 2 of 4 pixels
+static inline __m128i SwapRB(__m128i px)
+{
+	const __m128i rbmask = _mm_set1_epi32(0x00FF00FF);
+	const __m128i rb = _mm_and_si128(px, rbmask);
+	return _mm_or_si128(_mm_andnot_si128(rbmask, px),
+		_mm_or_si128(_mm_srli_epi32(rb, 16), _mm_and_si128(_mm_slli_epi32(rb, 16), rbmask)));
+}
+
+// Adjust the colour of 4 pixels in source byte order
+//   The matrix is applied to bytes 0 - 2 in float and saturated
+//   to 0 - 255, then each byte is replaced from its table.
+//   Alpha is not changed.
+static inline __m128i AdjustPixels(__m128i px, const SpoutColourAdjust& adjust)
+{
+	if (adjust.bMatrix) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i alpha = _mm_setr_epi32(0, 0, 0, -1);
+		const __m128 c0 = _mm_loadu_ps(adjust.columns);
+		const __m128 c1 = _mm_loadu_ps(adjust.columns + 4);
+		const __m128 c2 = _mm_loadu_ps(adjust.columns + 8);
+		const __m128i lo = _mm_unpacklo_epi8(px, zero);
+		const __m128i hi = _mm_unpackhi_epi8(px, zero);
+		__m128i p[4] = { _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+			_mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero) };
+		for (unsigned int i = 0; i < 4; i++) {
+			const __m128 f = _mm_cvtepi32_ps(p[i]);
+			__m128 m = _mm_mul_ps(c0, _mm_shuffle_ps(f, f, _MM_SHUFFLE(0, 0, 0, 0)));
+			m = _mm_add_ps(m, _mm_mul_ps(c1, _mm_shuffle_ps(f, f, _MM_SHUFFLE(1, 1, 1, 1))));
+			m = _mm_add_ps(m, _mm_mul_ps(c2, _mm_shuffle_ps(f, f, _MM_SHUFFLE(2, 2, 2, 2))));
+			p[i] = _mm_or_si128(_mm_andnot_si128(alpha, _mm_cvtps_epi32(m)), _mm_and_si128(alpha, p[i]));
+		}
+		px = _mm_packus_epi16(_mm_packs_epi32(p[0], p[1]), _mm_packs_epi32(p[2], p[3]));
+	}
+	if (adjust.bTables) {
+		alignas(16) unsigned char bytes[16];
+		_mm_store_si128(reinterpret_cast<__m128i*>(bytes), px);
+		for (unsigned int i = 0; i < 16; i += 4) {
+			bytes[i + 0] = adjust.table[0][bytes[i + 0]];
+			bytes[i + 1] = adjust.table[1][bytes[i + 1]];
+			bytes[i + 2] = adjust.table[2][bytes[i + 2]];
+		}
+		px = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+	}
+	return px;
+}
+
+// Adjust the colour of one rgba pixel in source byte order
+static inline void AdjustPixel(unsigned char* rgba, const SpoutColourAdjust& adjust)
+{
+	int value = 0;
+	memcpy(&value, rgba, 4);
+	value = _mm_cvtsi128_si32(AdjustPixels(_mm_cvtsi32_si128(value), adjust));
+	memcpy(rgba, &value, 4);
+}
+
+//
+// Resample helpers
+//
+
+// Integer factor 2 or 4 if the source is exactly that multiple
+// of the destination in both directions, otherwise zero
+static unsigned int DownsampleFactor(unsigned int sourceWidth, unsigned int sourceHeight,
+	unsigned int destWidth, unsigned int destHeight)
+{
+	if (destWidth == 0 || destHeight == 0)
+		return 0;
+	if (sourceWidth == destWidth*2 && sourceHeight == destHeight*2)
+		return 2;
+	if (sourceWidth == destWidth*4 && sourceHeight == destHeight*4)
+		return 4;
+	return 0;
+}
+
+// Integer factor of 2 or more if the destination is exactly that
+// multiple of the source in both directions, otherwise zero
+static unsigned int UpsampleFactor(unsigned int sourceWidth, unsigned int sourceHeight,
+	unsigned int destWidth, unsigned int destHeight)
+{
+	if (sourceWidth == 0 || sourceHeight == 0)
+		return 0;
+	const unsigned int factor = destWidth/sourceWidth;
+	if (factor < 2 || destWidth != sourceWidth*factor || destHeight != sourceHeight*factor)
+		return 0;
+	return factor;
+}
+
+// Store 4 rgba pixels as rgba or rgb with mirror and swap red/blue
+//   dx is the first of the 4 destination pixels before mirror.
+//   RGB packing uses rgbmask if SSSE3 is available.
+static inline void StorePixels(__m128i px, unsigned char* row, unsigned int dx, unsigned int width,
+	bool bRGB, bool bMirror, bool bSwapRB, bool bSSSE3, __m128i rgbmask)
+{
+	// Reverse the pixel order for mirror
+	if (bMirror) {
+		px = _mm_shuffle_epi32(px, _MM_SHUFFLE(0, 1, 2, 3));
+		dx = width - dx - 4;
+	}
+
+	if (!bRGB) {
+		if (bSwapRB)
+			px = SwapRB(px);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + (size_t)dx*4), px);
+		return;
+	}
+
+	unsigned char* d = row + (size_t)dx*3;
+	if (bSSSE3) {
+		// 12 bytes without writing past the block
+		const __m128i rgb = _mm_shuffle_epi8(px, rgbmask);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(d), rgb);
+		const int last = _mm_cvtsi128_si32(_mm_srli_si128(rgb, 8));
+		memcpy(d + 8, &last, 4);
+	}
+	else {
+		alignas(16) unsigned char pixels[16]={};
+		_mm_store_si128(reinterpret_cast<__m128i*>(pixels), px);
+		const unsigned int ir = bSwapRB ? 2 : 0;
+		const unsigned int ib = bSwapRB ? 0 : 2;
+		for (unsigned int i = 0; i < 4; i++) {
+			d[i*3 + ir] = pixels[i*4 + 0];
+			d[i*3 + 1]  = pixels[i*4 + 1];
+			d[i*3 + ib] = pixels[i*4 + 2];
+		}
+	}
+}
+
+// Average of adjacent pixel pairs of 8 rgba pixels to 4 pixels
+static inline __m128i AveragePairs(__m128i a, __m128i b)
+{
+	const __m128i even = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+	const __m128i odd  = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1)));
+	return _mm_avg_epu8(even, odd);
+}
+
+// 2x2 box average of 8 x 2 rgba pixels to 4 pixels
+static inline __m128i Box2(const unsigned char* p, unsigned int pitch)
+{
+	const __m128i v0 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + pitch)));
+	const __m128i v1 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)),
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + pitch + 16)));
+	return AveragePairs(v0, v1);
+}
+
+// 4x4 box average of 16 x 4 rgba pixels to 4 pixels
+static inline __m128i Box4(const unsigned char* p, unsigned int pitch)
+{
+	__m128i v[4];
+	for (unsigned int i = 0; i < 4; i++) {
+		const unsigned char* q = p + i*16;
+		const __m128i r01 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(q)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(q + pitch)));
+		const __m128i r23 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(q + (size_t)pitch*2)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(q + (size_t)pitch*3)));
+		v[i] = _mm_avg_epu8(r01, r23);
+	}
+	return AveragePairs(AveragePairs(v[0], v[1]), AveragePairs(v[2], v[3]));
+}
+
+// Box average of one factor x factor block of rgba pixels
+static inline void BoxPixel(const unsigned char* p, unsigned int pitch,
+	unsigned int factor, unsigned char* rgba)
+{
+	unsigned int sum[4]={};
+	for (unsigned int y = 0; y < factor; y++) {
+		const unsigned char* q = p + (size_t)y*pitch;
+		for (unsigned int x = 0; x < factor*4; x += 4) {
+			sum[0] += q[x + 0];
+			sum[1] += q[x + 1];
+			sum[2] += q[x + 2];
+			sum[3] += q[x + 3];
+		}
+	}
+	const unsigned int n = factor*factor;
+	for (unsigned int c = 0; c < 4; c++)
+		rgba[c] = (unsigned char)((sum[c] + n/2)/n);
+}
+
+//
+// High bit depth format helpers
+//
+// Each loader converts 4 pixels to 8 bit rgba in the order of the
+// source components. Adjacent loads 4 pixels from p. Gather loads the
+// pixels of a row at the column positions sx[0] - sx[3].
+//
+
+// 16 bit unsigned components to 8 bits rounded (v/257)
+static inline __m128i Unorm16To8(__m128i v)
+{
+	const __m128i t = _mm_adds_epu16(v, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_sub_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// Signed components with negative values clamped to zero
+// and 15 bits extended to 16 bits
+static inline __m128i Snorm16To16(__m128i v)
+{
+	v = _mm_max_epi16(v, _mm_setzero_si128());
+	return _mm_or_si128(_mm_slli_epi16(v, 1), _mm_srli_epi16(v, 14));
+}
+
+// Tone mapping of float components (see SetToneMapping)
+struct ToneCurve {
+	int mode;        // SPOUT_TONEMAP_NONE, REINHARD or ACES
+	__m128 exposure; // Exposure for colour and 1 for alpha
+};
+
+// Tone map the colour of one pixel of 4 floats
+//   Alpha is not changed. Negative and NaN values are zero and large
+//   values are limited so that infinity is mapped to 1.
+//   The division uses a reciprocal estimate and one Newton-Raphson step.
+//   The result matches spoutCopy::ToneMap to 8 bits.
+static inline __m128 ToneMapPixel(__m128 p, const ToneCurve& tone)
+{
+	const __m128 colour = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 x = _mm_min_ps(_mm_max_ps(_mm_mul_ps(p, tone.exposure), _mm_setzero_ps()),
+		_mm_set1_ps(SPOUT_TONEMAP_LIMIT));
+	__m128 num;
+	__m128 den;
+	if (tone.mode == SPOUT_TONEMAP_REINHARD) {
+		// x/(1 + x)
+		num = x;
+		den = _mm_add_ps(x, _mm_set1_ps(1.0f));
+	}
+	else if (tone.mode == SPOUT_TONEMAP_ACES) {
+		// Narkowicz ACES filmic fit
+		// x(2.51x + 0.03)/(x(2.43x + 0.59) + 0.14)
+		num = _mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(2.51f)), _mm_set1_ps(0.03f)));
+		den = _mm_add_ps(_mm_mul_ps(x, _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(2.43f)), _mm_set1_ps(0.59f))), _mm_set1_ps(0.14f));
+	}
+	else {
+		// Exposure only
+		return _mm_or_ps(_mm_and_ps(colour, x), _mm_andnot_ps(colour, p));
+	}
+	__m128 r = _mm_rcp_ps(den);
+	r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(den, r)));
+	return _mm_or_ps(_mm_and_ps(colour, _mm_mul_ps(num, r)), _mm_andnot_ps(colour, p));
+}
+
+// 4 pixels of 4 floats to 8 bit rgba clamped to 0 - 1
+// NaN is zero (_mm_max_ps returns the second operand)
+// Tone mapped if a curve is set
+static inline __m128i FloatTo8(__m128 p0, __m128 p1, __m128 p2, __m128 p3, const ToneCurve* tone)
+{
+	if (tone) {
+		p0 = ToneMapPixel(p0, *tone);
+		p1 = ToneMapPixel(p1, *tone);
+		p2 = ToneMapPixel(p2, *tone);
+		p3 = ToneMapPixel(p3, *tone);
+	}
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(255.0f);
+	const __m128i i0 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(p0, zero), one), scale));
+	const __m128i i1 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(p1, zero), one), scale));
+	const __m128i i2 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(p2, zero), one), scale));
+	const __m128i i3 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(p3, zero), one), scale));
+	return _mm_packus_epi16(_mm_packs_epi32(i0, i1), _mm_packs_epi32(i2, i3));
+}
+
+// 8 half floats to two groups of 4 floats without F16C
+//   Negative values and NaN are zero. Infinity is greater than 1.
+//   The exponent and mantissa are shifted to float positions and
+//   scaled by 2^112 to correct the exponent bias. Denormals are exact.
+static inline void HalfToFloat(__m128i h, __m128& lo, __m128& hi)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i negative = _mm_cmpgt_epi16(zero, h);
+	const __m128i nan = _mm_cmpgt_epi16(h, _mm_set1_epi16(0x7C00));
+	h = _mm_andnot_si128(_mm_or_si128(negative, nan), h);
+	const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(0x77800000)); // 2^112
+	lo = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_unpacklo_epi16(h, zero), 13)), magic);
+	hi = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(_mm_unpackhi_epi16(h, zero), 13)), magic);
+}
+
+// Two 8 byte pixels at column positions
+static inline __m128i LoadPair(const unsigned char* row, unsigned int x0, unsigned int x1)
+{
+	return _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + (size_t)x0*8)),
+		_mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + (size_t)x1*8)));
+}
+
+// DXGI_FORMAT_R16G16B16A16_UNORM (11)
+struct LoadUnorm16 {
+	static inline __m128i Convert(__m128i a, __m128i b) {
+		return _mm_packus_epi16(Unorm16To8(a), Unorm16To8(b));
+	}
+	static inline __m128i Adjacent(const unsigned char* p, const ToneCurve*) {
+		return Convert(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+	}
+	static inline __m128i Gather(const unsigned char* row, const unsigned int* sx, const ToneCurve*) {
+		return Convert(LoadPair(row, sx[0], sx[1]), LoadPair(row, sx[2], sx[3]));
+	}
+};
+
+// DXGI_FORMAT_R16G16B16A16_SNORM (13)
+struct LoadSnorm16 {
+	static inline __m128i Convert(__m128i a, __m128i b) {
+		return LoadUnorm16::Convert(Snorm16To16(a), Snorm16To16(b));
+	}
+	static inline __m128i Adjacent(const unsigned char* p, const ToneCurve*) {
+		return Convert(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)));
+	}
+	static inline __m128i Gather(const unsigned char* row, const unsigned int* sx, const ToneCurve*) {
+		return Convert(LoadPair(row, sx[0], sx[1]), LoadPair(row, sx[2], sx[3]));
+	}
+};
+
+// DXGI_FORMAT_R16G16B16A16_FLOAT (10) with SSE2
+struct LoadHalf {
+	static inline __m128i Convert(__m128i a, __m128i b, const ToneCurve* tone) {
+		__m128 p0, p1, p2, p3;
+		HalfToFloat(a, p0, p1);
+		HalfToFloat(b, p2, p3);
+		return FloatTo8(p0, p1, p2, p3, tone);
+	}
+	static inline __m128i Adjacent(const unsigned char* p, const ToneCurve* tone) {
+		return Convert(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), tone);
+	}
+	static inline __m128i Gather(const unsigned char* row, const unsigned int* sx, const ToneCurve* tone) {
+		return Convert(LoadPair(row, sx[0], sx[1]), LoadPair(row, sx[2], sx[3]), tone);
+	}
+};
+
+#ifndef _M_ARM64
+// DXGI_FORMAT_R16G16B16A16_FLOAT (10) with F16C
+// Compilers other than MSVC require the instruction set for the function
+#if defined(__GNUC__) || defined(__clang__)
+#define SPOUT_F16C __attribute__((target("f16c")))
+#else
+#define SPOUT_F16C
+#endif
+struct LoadHalfF16C {
+	SPOUT_F16C static inline __m128i Convert(__m128i a, __m128i b, const ToneCurve* tone) {
+		return FloatTo8(_mm_cvtph_ps(a), _mm_cvtph_ps(_mm_srli_si128(a, 8)),
+			_mm_cvtph_ps(b), _mm_cvtph_ps(_mm_srli_si128(b, 8)), tone);
+	}
+	SPOUT_F16C static inline __m128i Adjacent(const unsigned char* p, const ToneCurve* tone) {
+		return Convert(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), tone);
+	}
+	SPOUT_F16C static inline __m128i Gather(const unsigned char* row, const unsigned int* sx, const ToneCurve* tone) {
+		return Convert(LoadPair(row, sx[0], sx[1]), LoadPair(row, sx[2], sx[3]), tone);
+	}
+};
+#endif
+
+// DXGI_FORMAT_R10G10B10A2_UNORM (24)
+struct LoadUnorm10 {
+	static inline __m128i Convert(__m128i v) {
+		const __m128i mask = _mm_set1_epi32(0x3FF);
+		// 10 bits extended to 16 bits, then rounded to 8 bits
+		const __m128i r = _mm_and_si128(v, mask);
+		const __m128i g = _mm_and_si128(_mm_srli_epi32(v, 10), mask);
+		const __m128i b = _mm_and_si128(_mm_srli_epi32(v, 20), mask);
+		const __m128i r8 = Unorm16To8(_mm_or_si128(_mm_slli_epi32(r, 6), _mm_srli_epi32(r, 4)));
+		const __m128i g8 = Unorm16To8(_mm_or_si128(_mm_slli_epi32(g, 6), _mm_srli_epi32(g, 4)));
+		const __m128i b8 = Unorm16To8(_mm_or_si128(_mm_slli_epi32(b, 6), _mm_srli_epi32(b, 4)));
+		// 2 bit alpha x 85
+		const __m128i a = _mm_srli_epi32(v, 30);
+		const __m128i a8 = _mm_or_si128(_mm_or_si128(a, _mm_slli_epi32(a, 2)), _mm_or_si128(_mm_slli_epi32(a, 4), _mm_slli_epi32(a, 6)));
+		return _mm_or_si128(_mm_or_si128(r8, _mm_slli_epi32(g8, 8)), _mm_or_si128(_mm_slli_epi32(b8, 16), _mm_slli_epi32(a8, 24)));
+	}
+	static inline __m128i Adjacent(const unsigned char* p, const ToneCurve*) {
+		return Convert(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+	}
+	static inline __m128i Gather(const unsigned char* row, const unsigned int* sx, const ToneCurve*) {
+		uint32_t px[4];
+		for (unsigned int i = 0; i < 4; i++)
+			memcpy(&px[i], row + (size_t)sx[i]*4, 4);
+		return Convert(_mm_loadu_si128(reinterpret_cast<const __m128i*>(px)));
+	}
+};
+
+// DXGI_FORMAT_R8G8B8A8_UNORM (28) or B8G8R8A8_UNORM (87) for rotation
+struct LoadRgba8 {
+	static inline __m128i Adjacent(const unsigned char* p, const ToneCurve*) {
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	}
+	static inline __m128i Gather(const unsigned char* row, const unsigned int* sx, const ToneCurve*) {
+		uint32_t px[4];
+		for (unsigned int i = 0; i < 4; i++)
+			memcpy(&px[i], row + (size_t)sx[i]*4, 4);
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(px));
+	}
+};
+
+// Store the last 1 - 3 of 4 converted rgba pixels
+static inline void StoreTail(__m128i px, unsigned char* row, unsigned int dx, unsigned int count,
+	unsigned int width, bool bRGB, bool bMirror, bool bSwapRB)
+{
+	alignas(16) unsigned char pixels[16]={};
+	_mm_store_si128(reinterpret_cast<__m128i*>(pixels), px);
+	const unsigned int bpp = bRGB ? 3 : 4;
+	const unsigned int ir = bSwapRB ? 2 : 0;
+	const unsigned int ib = bSwapRB ? 0 : 2;
+	for (unsigned int i = 0; i < count; i++) {
+		const unsigned int x = bMirror ? (width - dx - i - 1) : (dx + i);
+		unsigned char* d = row + (size_t)x*bpp;
+		d[ir] = pixels[i*4 + 0];
+		d[1]  = pixels[i*4 + 1];
+		d[ib] = pixels[i*4 + 2];
+		if (!bRGB)
+			d[3] = pixels[i*4 + 3];
+	}
+}
+
+// Convert one row of a high bit depth format
+//   Re-sample uses source columns of step/65536 for each pixel.
+//   Adjacent pixels are converted if step is zero.
+template<typename Load>
+static inline void ConvertFormatRow(const unsigned char* source, unsigned int step,
+	unsigned int bytes, unsigned char* row, unsigned int width,
+	bool bRGB, bool bMirror, bool bSwapRB, bool bSSSE3, __m128i rgbmask, const ToneCurve* tone,
+	const SpoutColourAdjust* adjust)
+{
+	unsigned int sx[4]={};
+	unsigned int x = 0;
+	for (; x + 4 <= width; x += 4) {
+		__m128i px;
+		if (step) {
+			for (unsigned int i = 0; i < 4; i++)
+				sx[i] = (unsigned int)(((uint64_t)(x + i)*step) >> 16);
+			px = Load::Gather(source, sx, tone);
+		}
+		else {
+			px = Load::Adjacent(source + (size_t)x*bytes, tone);
+		}
+		if (adjust)
+			px = AdjustPixels(px, *adjust);
+		StorePixels(px, row, x, width, bRGB, bMirror, bSwapRB, bSSSE3, rgbmask);
+	}
+	if (x < width) {
+		// Repeat the last pixel rather than read past the row
+		for (unsigned int i = 0; i < 4; i++) {
+			const unsigned int last = (x + i < width) ? (x + i) : (width - 1);
+			sx[i] = step ? (unsigned int)(((uint64_t)last*step) >> 16) : last;
+		}
+		__m128i px = Load::Gather(source, sx, tone);
+		if (adjust)
+			px = AdjustPixels(px, *adjust);
+		StoreTail(px, row, x, width - x, width, bRGB, bMirror, bSwapRB);
+	}
+}
+
+// Convert and store a 4x4 block of pixels rotated by 90 or 270 degrees
+//   Four source rows of 4 pixels are transposed so that each source
+//   column becomes one destination row. rows[] are the destination rows
+//   of the source columns.
+template<typename Load>
+static inline void RotateBlock(const unsigned char* p0, const unsigned char* p1,
+	const unsigned char* p2, const unsigned char* p3, unsigned char* const* rows,
+	unsigned int dx, unsigned int width, bool bRGB, bool bMirror, bool bSwapRB,
+	bool bSSSE3, __m128i rgbmask, const ToneCurve* tone, const SpoutColourAdjust* adjust)
+{
+	const __m128i a0 = Load::Adjacent(p0, tone);
+	const __m128i a1 = Load::Adjacent(p1, tone);
+	const __m128i a2 = Load::Adjacent(p2, tone);
+	const __m128i a3 = Load::Adjacent(p3, tone);
+	const __m128i t0 = _mm_unpacklo_epi32(a0, a1);
+	const __m128i t1 = _mm_unpacklo_epi32(a2, a3);
+	const __m128i t2 = _mm_unpackhi_epi32(a0, a1);
+	const __m128i t3 = _mm_unpackhi_epi32(a2, a3);
+	__m128i px[4] = { _mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+		_mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3) };
+	for (unsigned int i = 0; i < 4; i++) {
+		if (adjust)
+			px[i] = AdjustPixels(px[i], *adjust);
+		StorePixels(px[i], rows[i], dx, width, bRGB, bMirror, bSwapRB, bSSSE3, rgbmask);
+	}
+}
+
+// Convert destination rows y0 - y1 of a source rotated by 90 or 270 degrees
+//   Each destination row is a source column. Same size rotations are
+//   done by 4x4 blocks along bands of 4 destination rows, so each source
+//   row is read 4 pixels at a time instead of one pixel per row, and the
+//   rest of each cache line is read from cache by the next bands.
+//   Bands of 16 rows with 4 blocks down each band were slower, because
+//   of the extra destination rows written at the same time.
+//   Other sizes and the remaining rows are re-sampled to the nearest
+//   pixel, one destination row at a time.
+template<typename Load>
+static void RotateRows(const unsigned char* source, unsigned int pitch, unsigned int bytes,
+	unsigned int sourceWidth, unsigned int sourceHeight, bool b90,
+	unsigned char* dest, unsigned int destPitch, unsigned int destWidth, unsigned int destHeight,
+	unsigned int y0, unsigned int y1, bool bRGB, bool bInvert, bool bMirror, bool bSwapRB,
+	bool bSSSE3, __m128i rgbmask, const ToneCurve* tone, const SpoutColourAdjust* adjust)
+{
+	// Rotated size is the source height by the source width
+	const bool bSame = (destWidth == sourceHeight && destHeight == sourceWidth);
+	const unsigned int step = bSame ? 0 : (unsigned int)(((uint64_t)sourceHeight << 16)/destWidth);
+
+	auto DestRow = [&](unsigned int y) {
+		return dest + (size_t)(bInvert ? (destHeight - y - 1) : y)*destPitch;
+	};
+
+	// Destination row y from column x
+	alignas(16) unsigned char pixels[32]={};
+	auto ConvertRow = [&](unsigned int y, unsigned int x) {
+		const unsigned int v = bSame ? y : (unsigned int)(((uint64_t)y*sourceWidth)/destHeight);
+		const unsigned char* column = source + (size_t)(b90 ? v : (sourceWidth - v - 1))*bytes;
+		unsigned char* row = DestRow(y);
+		for (; x < destWidth; x += 4) {
+			// Repeat the last pixel rather than read past the column
+			for (unsigned int i = 0; i < 4; i++) {
+				const unsigned int dx = (x + i < destWidth) ? (x + i) : (destWidth - 1);
+				const unsigned int u = step ? (unsigned int)(((uint64_t)dx*step) >> 16) : dx;
+				const unsigned int sy = b90 ? (sourceHeight - u - 1) : u;
+				memcpy(pixels + i*bytes, column + (size_t)sy*pitch, bytes);
+			}
+			__m128i px = Load::Adjacent(pixels, tone);
+			if (adjust)
+				px = AdjustPixels(px, *adjust);
+			if (x + 4 <= destWidth)
+				StorePixels(px, row, x, destWidth, bRGB, bMirror, bSwapRB, bSSSE3, rgbmask);
+			else
+				StoreTail(px, row, x, destWidth - x, destWidth, bRGB, bMirror, bSwapRB);
+		}
+	};
+
+	unsigned int y = y0;
+	if (bSame) {
+		const ptrdiff_t next = b90 ? -(ptrdiff_t)pitch : (ptrdiff_t)pitch;
+		for (; y + 4 <= y1; y += 4) {
+			// 90 degrees : source columns y to y + 3, rows from the bottom up
+			// 270 degrees : source columns width - y - 4 to width - y - 1,
+			// rows from the top down. The columns are in reverse order.
+			unsigned char* rows[4]={};
+			for (unsigned int i = 0; i < 4; i++)
+				rows[i] = DestRow(b90 ? (y + i) : (y + 3 - i));
+			const unsigned char* column = source + (size_t)(b90 ? y : (sourceWidth - y - 4))*bytes;
+			unsigned int x = 0;
+			for (; x + 4 <= destWidth; x += 4) {
+				const unsigned char* p = column + (size_t)(b90 ? (sourceHeight - x - 1) : x)*pitch;
+				RotateBlock<Load>(p, p + next, p + next*2, p + next*3, rows,
+					x, destWidth, bRGB, bMirror, bSwapRB, bSSSE3, rgbmask, tone, adjust);
+			}
+			// Remaining columns of the band
+			if (x < destWidth) {
+				for (unsigned int i = 0; i < 4; i++)
+					ConvertRow(y + i, x);
+			}
+		}
+	}
+
+	// Remaining rows, or all rows if re-sampled
+	for (; y < y1; y++)
+		ConvertRow(y, 0);
+}
+
+typedef void (*FormatRowFunction)(const unsigned char* source, unsigned int step,
+	unsigned int bytes, unsigned char* row, unsigned int width,
+	bool bRGB, bool bMirror, bool bSwapRB, bool bSSSE3, __m128i rgbmask, const ToneCurve* tone,
+	const SpoutColourAdjust* adjust);
+
+typedef void (*RotateFunction)(const unsigned char* source, unsigned int pitch, unsigned int bytes,
+	unsigned int sourceWidth, unsigned int sourceHeight, bool b90,
+	unsigned char* dest, unsigned int destPitch, unsigned int destWidth, unsigned int destHeight,
+	unsigned int y0, unsigned int y1, bool bRGB, bool bInvert, bool bMirror, bool bSwapRB,
+	bool bSSSE3, __m128i rgbmask, const ToneCurve* tone, const SpoutColourAdjust* adjust);
+
+// Format dispatch table
+//   DXGI format numbers are used to avoid including DirectX headers.
+//   The first entry for a format that the processor supports is used.
+struct FormatConversion {
+	DWORD format;           // DXGI format
+	unsigned int bytes;     // Bytes for each pixel
+	bool bF16C;             // Requires F16C
+	FormatRowFunction row;  // Row conversion
+	RotateFunction rotate;  // Rotated row conversion
+};
+
+static const FormatConversion FormatTable[] = {
+	{ 11, 8, false, ConvertFormatRow<LoadUnorm16>, RotateRows<LoadUnorm16> },   // DXGI_FORMAT_R16G16B16A16_UNORM
+	{ 13, 8, false, ConvertFormatRow<LoadSnorm16>, RotateRows<LoadSnorm16> },   // DXGI_FORMAT_R16G16B16A16_SNORM
+#ifndef _M_ARM64
+	{ 10, 8, true,  ConvertFormatRow<LoadHalfF16C>, RotateRows<LoadHalfF16C> }, // DXGI_FORMAT_R16G16B16A16_FLOAT
+#endif
+	{ 10, 8, false, ConvertFormatRow<LoadHalf>, RotateRows<LoadHalf> },         // DXGI_FORMAT_R16G16B16A16_FLOAT
+	{ 24, 4, false, ConvertFormatRow<LoadUnorm10>, RotateRows<LoadUnorm10> },   // DXGI_FORMAT_R10G10B10A2_UNORM
+};
+
+// 8 bit rgba or bgra formats are rotated without conversion
+static const FormatConversion Rgba8Conversion = { 87, 4, false, ConvertFormatRow<LoadRgba8>, RotateRows<LoadRgba8> };
+
+static const FormatConversion* FindFormat(DWORD format, bool bF16C)
+{
+	for (const FormatConversion& entry : FormatTable) {
+		if (entry.format == format && (bF16C || !entry.bF16C))
+			return &entry;
+	}
+	return nullptr;
+}
+
+//
+// Row helpers
+//
+
+// Exchange two rows, 64 bytes at a time
+static inline void SwapRows(unsigned char* a, unsigned char* b, size_t size)
+{
+	size_t n = 0;
+	for (; n + 64 <= size; n += 64) {
+		const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n));
+		const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n + 16));
+		const __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n + 32));
+		const __m128i a3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n + 48));
+		const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n));
+		const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n + 16));
+		const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n + 32));
+		const __m128i b3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n + 48));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(a + n), b0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(a + n + 16), b1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(a + n + 32), b2);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(a + n + 48), b3);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + n), a0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + n + 16), a1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + n + 32), a2);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + n + 48), a3);
+	}
+	for (; n + 16 <= size; n += 16) {
+		const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n));
+		const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(a + n), b0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + n), a0);
+	}
+	for (; n < size; n++) {
+		const unsigned char t = a[n];
+		a[n] = b[n];
+		b[n] = t;
+	}
+}
+
 //
 // Class: spoutCopy
 //
@@ -188,7 +853,7 @@ void spoutCopy::FlipBuffer(const unsigned char *src,
 //---------------------------------------------------------
 // Function: FlipBuffer
 // Flip a pixel buffer in place
-// No otimization - memcpy only
+// Rows are exchanged in registers without a row buffer
 void spoutCopy::FlipBuffer(unsigned char* src,
 			unsigned int width, unsigned int height,
 			GLenum glFormat) const
@@ -202,18 +867,11 @@ void spoutCopy::FlipBuffer(unsigned char* src,
 	else if (glFormat == GL_RGB || glFormat == GL_BGR_EXT)
 		pitch = width * 3; // RGB format specified (RGB float not supported)
 
-	// Allocate a one row buffer
-	unsigned char* tempRow = new unsigned char[pitch];
-
-    for (unsigned int y = 0; y<height/2; y++) {
-		unsigned char* rowTop = src + y*pitch;
-        unsigned char* rowBottom = src + (height-1-y)*pitch;
-        memcpy(tempRow,   rowTop,    pitch); // Save top row
-        memcpy(rowTop,    rowBottom, pitch); // Copy bottom to top
-        memcpy(rowBottom, tempRow,   pitch); // Copy saved top to bottom
-    }
-
-	delete[] tempRow;
+	for (unsigned int y = 0; y<height/2; y++) {
+		unsigned char* rowTop = src + (size_t)y*pitch;
+		unsigned char* rowBottom = src + (size_t)(height-1-y)*pitch;
+		SwapRows(rowTop, rowBottom, pitch);
+	}
 
 }
 
@@ -230,22 +888,18 @@ void spoutCopy::RemovePadding(const unsigned char *source, unsigned char *dest,
 	if (glFormat == GL_RGB || glFormat == GL_BGR_EXT)
 		pitch = width*3; // rgb
 
+	// memcpy_sse2 requires 16 byte aligned rows for every line
+	const bool bAligned = ((reinterpret_cast<uintptr_t>(source) | reinterpret_cast<uintptr_t>(dest)
+		| pitch | stride) % 16) == 0;
+
 	// Remove the padding (stride-pitch)
+	// memcpy is as fast as an SSE2 copy for rows that are not aligned
+	// (tools\SpoutCopy\SpoutBufferBench)
 	for (unsigned int y = 0; y < height; y++) {
-		// Avoid warning C26474 and use implicit cast where possible
-		if (pitch < 320 || stride < 320) { // too small for assembler
-			// memcpy(reinterpret_cast<void *>(dest), reinterpret_cast<const void *>(source), pitch);
-			memcpy(dest, source, pitch);
-		}
-		else if ((pitch % 16) == 0 && (stride % 16) == 0 && m_bSSE2) { // use sse
-			// memcpy_sse2(reinterpret_cast<void *>(dest), reinterpret_cast<const void *>(source), pitch);
+		if (m_bSSE2 && bAligned && pitch >= 320) { // use sse streaming copy
 			memcpy_sse2(dest, source, pitch);
 		}
-		else if ((pitch % 4) == 0 && (stride % 4) == 0) { // 4 byte move
-			__movsd(reinterpret_cast<unsigned long *>(dest), reinterpret_cast<const unsigned long *>(source), pitch/4);
-		}
 		else {
-			// memcpy(reinterpret_cast<void *>(dest), reinterpret_cast<const void *>(source), pitch);
 			memcpy(dest, source, pitch);
 		}
 		source += stride;
@@ -258,8 +912,29 @@ void spoutCopy::RemovePadding(const unsigned char *source, unsigned char *dest,
 // Clear alpha of rgba image pixels to the required value
 void spoutCopy::ClearAlpha(unsigned char* src, unsigned int width, unsigned int height, unsigned char alpha) const
 {
+	if (!src) return;
+
 	unsigned char* pixels = src;
-	for (unsigned int i = 0; i<width*height; i++) {
+	const size_t count = (size_t)width*height;
+	size_t i = 0;
+
+	// Keep the colour bytes and insert alpha, 16 pixels at a time
+	const __m128i rgbmask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i alphamask = _mm_set1_epi32((int)((unsigned int)alpha << 24));
+	for (; i + 16 <= count; i += 16) {
+		__m128i* p = reinterpret_cast<__m128i*>(pixels);
+		const __m128i p0 = _mm_loadu_si128(p);
+		const __m128i p1 = _mm_loadu_si128(p + 1);
+		const __m128i p2 = _mm_loadu_si128(p + 2);
+		const __m128i p3 = _mm_loadu_si128(p + 3);
+		_mm_storeu_si128(p,     _mm_or_si128(_mm_and_si128(p0, rgbmask), alphamask));
+		_mm_storeu_si128(p + 1, _mm_or_si128(_mm_and_si128(p1, rgbmask), alphamask));
+		_mm_storeu_si128(p + 2, _mm_or_si128(_mm_and_si128(p2, rgbmask), alphamask));
+		_mm_storeu_si128(p + 3, _mm_or_si128(_mm_and_si128(p3, rgbmask), alphamask));
+		pixels += 64;
+	}
+
+	for (; i < count; i++) {
 		*(pixels + 3) = alpha; // alpha is the last of the 4 bytes
 		pixels += 4; // move the pointer along to the next rgba pixel
 	}
@@ -346,6 +1021,122 @@ void spoutCopy::memcpy_sse2(void* dst, const void* src, size_t Size) const
 
 }
 
+//---------------------------------------------------------
+// Function: FillPixels
+// Fill pixels of 3 or 4 bytes with a colour using streaming stores
+//   count - number of pixels
+//   pixel - bytes of one pixel in destination order
+//   A 48 byte pattern holds a whole number of 3 and 4 byte pixels.
+//   Bytes before the first 16 byte boundary and after the last are
+//   written separately.
+void spoutCopy::FillPixels(unsigned char* dest, size_t count, unsigned int bpp,
+	const unsigned char* pixel) const
+{
+	if (!dest || !pixel || count == 0 || (bpp != 3 && bpp != 4))
+		return;
+
+	const size_t size = count*bpp;
+	size_t n = 0;
+
+	// Bytes to the first 16 byte boundary
+	size_t head = (16 - ((uintptr_t)dest % 16)) % 16;
+	if (head > size) head = size;
+	for (; n < head; n++)
+		dest[n] = pixel[n % bpp];
+
+	// Pattern starting at the byte of the pixel at the boundary
+	if (m_bSSE2 && size - n >= 48) {
+		alignas(16) unsigned char pattern[48]={};
+		for (unsigned int i = 0; i < 48; i++)
+			pattern[i] = pixel[(n + i) % bpp];
+		const __m128i p0 = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern));
+		const __m128i p1 = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern + 16));
+		const __m128i p2 = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern + 32));
+		for (; n + 48 <= size; n += 48) {
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dest + n), p0);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dest + n + 16), p1);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dest + n + 32), p2);
+		}
+		_mm_sfence();
+	}
+
+	// Remaining bytes
+	for (; n < size; n++)
+		dest[n] = pixel[n % bpp];
+}
+
+//---------------------------------------------------------
+// Function: HashRows
+// Hash of rows of pixel data to detect changes between frames
+//   Two sums of 32 bit lanes for each 16 bytes. The second sum
+//   depends on the position of the data, so that pixels that move
+//   change the hash. Only for change detection, not for security.
+uint64_t spoutCopy::HashRows(const void* source, unsigned int rowbytes,
+	unsigned int rows, unsigned int pitch) const
+{
+	if (!source)
+		return 0;
+
+	auto pSrc = static_cast<const unsigned char *>(source);
+	const unsigned int blocks = rowbytes/16;
+	const unsigned int tail = rowbytes % 16;
+
+	uint32_t sum[4]={};
+	uint32_t pos[4]={};
+	uint32_t tailsum = 0;
+	uint32_t tailpos = 0;
+
+	if (m_bSSE2) {
+		__m128i Sum = _mm_setzero_si128();
+		__m128i Pos = _mm_setzero_si128();
+		for (unsigned int y = 0; y < rows; y++) {
+			auto pRow = reinterpret_cast<const __m128i *>(pSrc + (size_t)y*pitch);
+			for (unsigned int x = 0; x < blocks; x++) {
+				// The row pitch may not be 16 byte aligned
+				Sum = _mm_add_epi32(Sum, _mm_loadu_si128(pRow + x));
+				Pos = _mm_add_epi32(Pos, Sum);
+			}
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(sum), Sum);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pos), Pos);
+	}
+	else {
+		for (unsigned int y = 0; y < rows; y++) {
+			const unsigned char* pRow = pSrc + (size_t)y*pitch;
+			for (unsigned int x = 0; x < blocks; x++) {
+				for (unsigned int i = 0; i < 4; i++) {
+					uint32_t word = 0;
+					memcpy(&word, pRow + x*16 + i*4, 4);
+					sum[i] += word;
+					pos[i] += sum[i];
+				}
+			}
+		}
+	}
+
+	// Trailing bytes for lines not divisible by 16
+	if (tail > 0) {
+		for (unsigned int y = 0; y < rows; y++) {
+			const unsigned char* pTail = pSrc + (size_t)y*pitch + (size_t)blocks*16;
+			for (unsigned int i = 0; i < tail; i++) {
+				tailsum += pTail[i];
+				tailpos += tailsum;
+			}
+		}
+	}
+
+	// Combine the lanes (FNV-1a 64 bit)
+	uint64_t hash = 14695981039346656037ULL;
+	for (unsigned int i = 0; i < 4; i++) {
+		hash = (hash ^ sum[i]) * 1099511628211ULL;
+		hash = (hash ^ pos[i]) * 1099511628211ULL;
+	}
+	hash = (hash ^ tailsum) * 1099511628211ULL;
+	hash = (hash ^ tailpos) * 1099511628211ULL;
+
+	return hash;
+}
+
 //
 // Group: RGBA <> RGBA
 //
@@ -386,6 +1177,8 @@ void spoutCopy::rgba2rgba(const void* rgba_source, void* rgba_dest,
 		}
 		// Copy the line as fast as possible
 		CopyPixels((const unsigned char*)source, (unsigned char*)dest, width, 1);
+		if (m_bAdjust)
+			AdjustRow((unsigned char*)dest, width, 4, false);
 	}
 }
 
@@ -420,6 +1213,8 @@ void spoutCopy::rgba2rgba(const void* rgba_source, void* rgba_dest,
 		}
 		// Copy the line as fast as possible
 		CopyPixels((const unsigned char*)source, (unsigned char*)dest, width, 1);
+		if (m_bAdjust)
+			AdjustRow((unsigned char*)dest, width, 4, false);
 	}
 }
 
@@ -433,11 +1228,64 @@ void spoutCopy::rgba2rgba(const void* rgba_source, void* rgba_dest,
 void spoutCopy::rgba2rgbaResample(const void* source, void* dest,
 	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
 	unsigned int destWidth, unsigned int destHeight, bool bInvert) const
+{
+	rgba2rgbaResample(source, dest, sourceWidth, sourceHeight, sourcePitch,
+		destWidth, destHeight, destWidth*4, bInvert);
+}
+
+//---------------------------------------------------------
+// Function: rgba2rgbaResample
+// Copy rgba buffers of differing size allowing for destination pitch
+//   To re-sample into part of a larger buffer.
+void spoutCopy::rgba2rgbaResample(const void* source, void* dest,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight, unsigned int destPitch, bool bInvert) const
+{
+	rgba2rgbaResample(source, dest, sourceWidth, sourceHeight, sourcePitch,
+		destWidth, destHeight, destPitch, 0, destHeight, bInvert);
+}
+
+//---------------------------------------------------------
+// Function: rgba2rgbaResample
+// Copy rgba buffers of differing size allowing for destination pitch
+//   Converts destination rows y0 - y1 so that rows can be divided
+//   into bands. The rows are before flip.
+void spoutCopy::rgba2rgbaResample(const void* source, void* dest,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+	unsigned int y0, unsigned int y1, bool bInvert) const
 {
 	const unsigned char* srcBuffer = (unsigned char*)source; // bgra source
 	unsigned char* dstBuffer = (unsigned char*)dest; // bgr dest
 	if (!srcBuffer || !dstBuffer)
 		return;
+	if (y1 > destHeight) y1 = destHeight;
+	if (y0 >= y1)
+		return;
+
+	// First destination row of the band after flip
+	const size_t dy = bInvert ? (destHeight - y1) : y0;
+
+	// Same size
+	if (sourceWidth == destWidth && sourceHeight == destHeight) {
+		rgba2rgba(srcBuffer + (size_t)y0*sourcePitch, dstBuffer + dy*destPitch,
+			destWidth, y1 - y0, sourcePitch, destPitch, bInvert);
+		return;
+	}
+
+	// Exact 2:1 or 4:1 box filter
+	const unsigned int factor = DownsampleFactor(sourceWidth, sourceHeight, destWidth, destHeight);
+	if (factor > 0 && m_bSSE2) {
+		rgba_downsample_sse2(source, dest, destWidth, destHeight, sourcePitch, destPitch, factor, y0, y1, false, bInvert, false, false);
+		return;
+	}
+
+	// Exact integer upscale by pixel replication
+	const unsigned int upfactor = UpsampleFactor(sourceWidth, sourceHeight, destWidth, destHeight);
+	if (upfactor > 0 && m_bSSE2) {
+		rgba_upsample_sse2(source, dest, sourceWidth, sourceHeight, sourcePitch, destPitch, upfactor, y0, y1, false, bInvert, false, false);
+		return;
+	}
 
 	// horizontal and vertical ratios between the original image and the to be scaled image
 	const float x_ratio = (float)sourceWidth / (float)destWidth;
@@ -446,16 +1294,16 @@ void spoutCopy::rgba2rgbaResample(const void* source, void* dest,
 	float py = 0.0f;
 	unsigned int i =- 0;
 	unsigned int j = 0;
-	unsigned int pixel = 0;
+	size_t pixel = 0;
 	int nearestMatch = 0;
-	for (i = 0; i < destHeight; i++) {
+	for (i = y0; i < y1; i++) {
 		for (j = 0; j < destWidth; j++) {
 			px = floor((float)j*x_ratio);
 			py = floor((float)i*y_ratio);
 			if (bInvert)
-				pixel = (destHeight - i - 1)*destWidth * 4 + j * 4; // flip vertically
+				pixel = (size_t)(destHeight - i - 1)*destPitch + j * 4; // flip vertically
 			else
-				pixel = i * destWidth * 4 + j * 4;
+				pixel = (size_t)i*destPitch + j * 4;
 			nearestMatch = (int)(py*sourcePitch + px * 4);
 			dstBuffer[pixel + 0] = srcBuffer[nearestMatch + 0];
 			dstBuffer[pixel + 1] = srcBuffer[nearestMatch + 1];
@@ -463,6 +1311,8 @@ void spoutCopy::rgba2rgbaResample(const void* source, void* dest,
 			dstBuffer[pixel + 3] = srcBuffer[nearestMatch + 3];
 		}
 	}
+	if (m_bAdjust)
+		AdjustColour(dstBuffer + dy*destPitch, destWidth, y1 - y0, destPitch, 4, false);
 }
 
 //
@@ -533,6 +1383,8 @@ void spoutCopy::rgba2bgra(const void *rgba_source, void *bgra_dest,
 		else {
 			rgba_bgra(source, dest, width, 1);
 		}
+		if (m_bAdjust)
+			AdjustRow((unsigned char*)dest, width, 4, true);
 	}
 }
 
@@ -578,6 +1430,8 @@ void spoutCopy::rgba2bgra(const void* rgba_source, void* bgra_dest,
 		else {
 			rgba_bgra(source, dest, width, 1);
 		}
+		if (m_bAdjust)
+			AdjustRow((unsigned char*)dest, width, 4, true);
 
 	}
 }
@@ -672,6 +1526,8 @@ void spoutCopy::rgba2rgb(const void* rgba_source, void* rgb_dest,
 			}
 			rgba += 4;
 		}
+		if (m_bAdjust)
+			AdjustRow(rgb, width, 3, bSwapRB);
 		rgb += (uint64_t)width * 3;
 		rgba += rgba_padding;
 
@@ -1049,6 +1905,9 @@ void spoutCopy::rgba_to_rgb_sse3(const void* rgba_source, void* rgb_dest,
 	// Dest and source must be the same dimensions otherwise
 	unsigned int rgba_padding = rgba_pitch-width*4; // byte line padding
 
+	// Colour adjustment (see SetColourAdjust)
+	const SpoutColourAdjust* adjust = m_bAdjust ? &m_Adjust : nullptr;
+
 	// Flip image option, move to the beginning of the last rgb line
 	if (bInvert) {
 		out_vec += rgbsize/16; // end of rgb buffer
@@ -1073,6 +1932,14 @@ void spoutCopy::rgba_to_rgb_sse3(const void* rgba_source, void* rgb_dest,
 			in2 = in_vec[2];   // Third 128 bits RGBA
 			in3 = in_vec[3];   // Fourth 128 bits RGBA
 
+			// Colour adjustment before packing
+			if (adjust) {
+				in0 = AdjustPixels(in0, *adjust);
+				in1 = AdjustPixels(in1, *adjust);
+				in2 = AdjustPixels(in2, *adjust);
+				in3 = AdjustPixels(in3, *adjust);
+			}
+
 			if (!bSwapRB) { // No swap
 				//
 				// RGBA > RGB
@@ -1324,11 +2191,65 @@ void spoutCopy::rgba2rgbResample(const void* source, void* dest,
 	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
 	unsigned int destWidth, unsigned int destHeight, bool bInvert, bool bMirror, bool bSwapRB) const
 {
+	rgba2rgbResample(source, dest, sourceWidth, sourceHeight, sourcePitch,
+		destWidth, destHeight, destWidth*3, bInvert, bMirror, bSwapRB);
+}
+
+//---------------------------------------------------------
+// Function: rgba2rgbResample
+// Allowing for destination pitch
+//   To re-sample into part of a larger buffer.
+void spoutCopy::rgba2rgbResample(const void* source, void* dest,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+	bool bInvert, bool bMirror, bool bSwapRB) const
+{
+	rgba2rgbResample(source, dest, sourceWidth, sourceHeight, sourcePitch,
+		destWidth, destHeight, destPitch, 0, destHeight, bInvert, bMirror, bSwapRB);
+}
+
+//---------------------------------------------------------
+// Function: rgba2rgbResample
+// Allowing for destination pitch
+//   Converts destination rows y0 - y1 so that rows can be divided
+//   into bands. The rows are before flip.
+void spoutCopy::rgba2rgbResample(const void* source, void* dest,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+	unsigned int y0, unsigned int y1, bool bInvert, bool bMirror, bool bSwapRB) const
+{
 
 	const unsigned char* srcBuffer = (unsigned char*)source; // bgra source
 	unsigned char* dstBuffer = (unsigned char*)dest; // bgr dest
 	if (!srcBuffer || !dstBuffer)
 		return;
+	if (y1 > destHeight) y1 = destHeight;
+	if (y0 >= y1)
+		return;
+
+	// Same size, line by line for the destination pitch
+	if (sourceWidth == destWidth && sourceHeight == destHeight) {
+		for (unsigned int i = y0; i < y1; i++) {
+			const unsigned int y = bInvert ? (destHeight - i - 1) : i;
+			rgba2rgb(srcBuffer + (size_t)i*sourcePitch, dstBuffer + (size_t)y*destPitch,
+				destWidth, 1, sourcePitch, false, bMirror, bSwapRB);
+		}
+		return;
+	}
+
+	// Exact 2:1 or 4:1 box filter
+	const unsigned int factor = DownsampleFactor(sourceWidth, sourceHeight, destWidth, destHeight);
+	if (factor > 0 && m_bSSE2) {
+		rgba_downsample_sse2(source, dest, destWidth, destHeight, sourcePitch, destPitch, factor, y0, y1, true, bInvert, bMirror, bSwapRB);
+		return;
+	}
+
+	// Exact integer upscale by pixel replication
+	const unsigned int upfactor = UpsampleFactor(sourceWidth, sourceHeight, destWidth, destHeight);
+	if (upfactor > 0 && m_bSSE2) {
+		rgba_upsample_sse2(source, dest, sourceWidth, sourceHeight, sourcePitch, destPitch, upfactor, y0, y1, true, bInvert, bMirror, bSwapRB);
+		return;
+	}
 
 	const float x_ratio = (float)sourceWidth / (float)destWidth;
 	const float y_ratio = (float)sourceHeight / (float)destHeight;
@@ -1343,24 +2264,24 @@ void spoutCopy::rgba2rgbResample(const void* source, void* dest,
 	float py = 0.0f;
 	unsigned int i = 0;
 	unsigned int j = 0;
-	unsigned int pixel = 0;
+	size_t pixel = 0;
 	int nearestMatch = 0;
-	for (i = 0; i < destHeight; i++) {
+	for (i = y0; i < y1; i++) {
 		for (j = 0; j < destWidth; j++) {
 			px = floor((float)j*x_ratio);
 			py = floor((float)i*y_ratio);
 
 			if (bMirror) {
 				if (bInvert)
-					pixel = (destHeight - i - 1)*destWidth * 3 + (destWidth - j - 1) * 3; // flip horizontally
+					pixel = (size_t)(destHeight - i - 1)*destPitch + (destWidth - j - 1) * 3; // flip horizontally
 				else
-					pixel = i * destWidth * 3 + (destWidth - j - 1) * 3;
+					pixel = (size_t)i*destPitch + (destWidth - j - 1) * 3;
 			}
 			else {
 				if (bInvert)
-					pixel = (destHeight - i - 1)*destWidth * 3 + j * 3; // flip vertically
+					pixel = (size_t)(destHeight - i - 1)*destPitch + j * 3; // flip vertically
 				else
-					pixel = i * destWidth * 3 + j * 3;
+					pixel = (size_t)i*destPitch + j * 3;
 			}
 
 			nearestMatch = (int)(py*sourcePitch + px * 4);
@@ -1369,6 +2290,10 @@ void spoutCopy::rgba2rgbResample(const void* source, void* dest,
 			dstBuffer[pixel + ib] = srcBuffer[nearestMatch + 2];
 		}
 	}
+	if (m_bAdjust) {
+		const size_t dy = bInvert ? (destHeight - y1) : y0;
+		AdjustColour(dstBuffer + dy*destPitch, destWidth, y1 - y0, destPitch, 3, bSwapRB);
+	}
 }
 
 //---------------------------------------------------------
@@ -1383,6 +2308,20 @@ void spoutCopy::rgba2bgrResample(const void* source, void* dest,
 	if (!srcBuffer || !dstBuffer)
 		return;
 
+	// Exact 2:1 or 4:1 box filter
+	const unsigned int factor = DownsampleFactor(sourceWidth, sourceHeight, destWidth, destHeight);
+	if (factor > 0 && m_bSSE2) {
+		rgba_downsample_sse2(source, dest, destWidth, destHeight, sourcePitch, destWidth*3, factor, 0, destHeight, true, bInvert, false, true);
+		return;
+	}
+
+	// Exact integer upscale by pixel replication
+	const unsigned int upfactor = UpsampleFactor(sourceWidth, sourceHeight, destWidth, destHeight);
+	if (upfactor > 0 && m_bSSE2) {
+		rgba_upsample_sse2(source, dest, sourceWidth, sourceHeight, sourcePitch, destWidth*3, upfactor, 0, destHeight, true, bInvert, false, true);
+		return;
+	}
+
 	const float x_ratio = (float)sourceWidth / (float)destWidth;
 	const float y_ratio = (float)sourceHeight / (float)destHeight;
 	float px = 0.0f;
@@ -1405,6 +2344,318 @@ void spoutCopy::rgba2bgrResample(const void* source, void* dest,
 			dstBuffer[pixel + 0] = srcBuffer[nearestMatch + 2];
 		}
 	}
+	if (m_bAdjust)
+		AdjustColour(dstBuffer, destWidth, destHeight, destWidth*3, 3, true);
+}
+
+//---------------------------------------------------------
+// Function: FormatBytes
+// Bytes for each pixel of a DXGI format converted by format2rgba
+//   Zero if the format cannot be converted.
+unsigned int spoutCopy::FormatBytes(DWORD dxgiFormat) const
+{
+	const FormatConversion* entry = FindFormat(dxgiFormat, m_bF16C);
+	if (!entry || !m_bSSE2)
+		return 0;
+	return entry->bytes;
+}
+
+//---------------------------------------------------------
+// Function: format2rgba
+// Convert 16 bit, half float or 10 bit pixels to 8 bit rgba or rgb
+//   DXGI formats 10, 11, 13 and 24 (see FormatTable).
+//   Components are in the source order (RGBA) unless swapped.
+//   A different size is re-sampled to the nearest pixel in the same pass.
+//   Returns false if the format cannot be converted.
+bool spoutCopy::format2rgba(const void* source, void* dest, DWORD dxgiFormat,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+	bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const
+{
+	return format2rgba(source, dest, dxgiFormat, sourceWidth, sourceHeight, sourcePitch,
+		destWidth, destHeight, destPitch, 0, destHeight, bRGB, bInvert, bMirror, bSwapRB);
+}
+
+//---------------------------------------------------------
+// Function: format2rgba
+// Convert 16 bit, half float or 10 bit pixels to 8 bit rgba or rgb
+//   Converts destination rows y0 - y1 so that rows can be divided
+//   into bands. The rows are before flip.
+bool spoutCopy::format2rgba(const void* source, void* dest, DWORD dxgiFormat,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+	unsigned int y0, unsigned int y1, bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const
+{
+	auto src = static_cast<const unsigned char*>(source);
+	auto dst = static_cast<unsigned char*>(dest);
+	if (!src || !dst || !m_bSSE2 || sourceWidth == 0 || sourceHeight == 0)
+		return false;
+	if (y1 > destHeight) y1 = destHeight;
+
+	const FormatConversion* entry = FindFormat(dxgiFormat, m_bF16C);
+	if (!entry)
+		return false;
+
+	// RGBA to RGB/BGR packing of 4 pixels (requires SSSE3)
+	const __m128i rgbmask = bSwapRB ?
+		_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+		_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+	// Tone mapping of half float formats
+	const ToneCurve curve = { m_ToneMap, _mm_setr_ps(m_Exposure, m_Exposure, m_Exposure, 1.0f) };
+	const ToneCurve* tone = nullptr;
+	if (dxgiFormat == 10 && (m_ToneMap != SPOUT_TONEMAP_NONE || m_Exposure != 1.0f))
+		tone = &curve;
+
+	// Source columns for each destination pixel (16.16 fixed point)
+	const unsigned int step = (sourceWidth == destWidth) ? 0
+		: (unsigned int)(((uint64_t)sourceWidth << 16)/destWidth);
+
+	for (unsigned int y = y0; y < y1; y++) {
+		const unsigned int sy = (sourceHeight == destHeight) ? y
+			: (unsigned int)(((uint64_t)y*sourceHeight)/destHeight);
+		const unsigned int dy = bInvert ? (destHeight - y - 1) : y;
+		entry->row(src + (size_t)sy*sourcePitch, step, entry->bytes, dst + (size_t)dy*destPitch,
+			destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask, tone, m_bAdjust ? &m_Adjust : nullptr);
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: rotate2rgba
+// Rotate pixels clockwise by 0, 90, 180 or 270 degrees to 8 bit rgba or rgb
+//   DXGI formats of format2rgba, or 8 bit rgba or bgra for other formats.
+//   The destination is the rotated source, re-sampled to the nearest
+//   pixel if a different size. Flip and mirror apply after rotation.
+//   Converts destination rows y0 - y1 so that rows can be divided
+//   into bands. Returns false if the format cannot be converted.
+bool spoutCopy::rotate2rgba(const void* source, void* dest, DWORD dxgiFormat,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+	unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+	unsigned int rotation, unsigned int y0, unsigned int y1,
+	bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const
+{
+	auto src = static_cast<const unsigned char*>(source);
+	auto dst = static_cast<unsigned char*>(dest);
+	if (!src || !dst || !m_bSSE2 || sourceWidth == 0 || sourceHeight == 0
+		|| destWidth == 0 || destHeight == 0)
+		return false;
+	if (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270)
+		return false;
+	if (y1 > destHeight) y1 = destHeight;
+
+	const FormatConversion* entry = FindFormat(dxgiFormat, m_bF16C);
+	if (!entry)
+		entry = &Rgba8Conversion;
+
+	const __m128i rgbmask = bSwapRB ?
+		_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+		_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+	const ToneCurve curve = { m_ToneMap, _mm_setr_ps(m_Exposure, m_Exposure, m_Exposure, 1.0f) };
+	const ToneCurve* tone = nullptr;
+	if (dxgiFormat == 10 && (m_ToneMap != SPOUT_TONEMAP_NONE || m_Exposure != 1.0f))
+		tone = &curve;
+	const SpoutColourAdjust* adjust = m_bAdjust ? &m_Adjust : nullptr;
+
+	if (rotation == 90 || rotation == 270) {
+		entry->rotate(src, sourcePitch, entry->bytes, sourceWidth, sourceHeight, rotation == 90,
+			dst, destPitch, destWidth, destHeight, y0, y1, bRGB, bInvert, bMirror, bSwapRB,
+			m_bSSSE3, rgbmask, tone, adjust);
+		return true;
+	}
+
+	// 0 and 180 degrees are rows of the source
+	// 180 degrees is the bottom row first, mirrored
+	const bool b180 = (rotation == 180);
+	const unsigned int step = (sourceWidth == destWidth) ? 0
+		: (unsigned int)(((uint64_t)sourceWidth << 16)/destWidth);
+	for (unsigned int y = y0; y < y1; y++) {
+		unsigned int sy = (sourceHeight == destHeight) ? y
+			: (unsigned int)(((uint64_t)y*sourceHeight)/destHeight);
+		if (b180)
+			sy = sourceHeight - sy - 1;
+		const unsigned int dy = bInvert ? (destHeight - y - 1) : y;
+		entry->row(src + (size_t)sy*sourcePitch, step, entry->bytes, dst + (size_t)dy*destPitch,
+			destWidth, bRGB, bMirror != b180, bSwapRB, m_bSSSE3, rgbmask, tone, adjust);
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------
+// Function: SetToneMapping
+// Tone mapping of half float formats converted by format2rgba
+//   SPOUT_TONEMAP_NONE     - clamp to 0 - 1 (default)
+//   SPOUT_TONEMAP_REINHARD - x/(1 + x)
+//   SPOUT_TONEMAP_ACES     - ACES filmic curve fit
+//   Colour is multiplied by the exposure before the curve.
+//   The curve is applied in the same pass as the conversion.
+void spoutCopy::SetToneMapping(int mode, float exposure)
+{
+	if (mode < SPOUT_TONEMAP_NONE || mode > SPOUT_TONEMAP_ACES)
+		mode = SPOUT_TONEMAP_NONE;
+	if (!(exposure > 0.0f))
+		exposure = 1.0f;
+	m_ToneMap = mode;
+	m_Exposure = exposure;
+}
+
+//---------------------------------------------------------
+// Function: GetToneMapping
+// Return tone mapping mode
+int spoutCopy::GetToneMapping() const
+{
+	return m_ToneMap;
+}
+
+//---------------------------------------------------------
+// Function: GetExposure
+// Return tone mapping exposure
+float spoutCopy::GetExposure() const
+{
+	return m_Exposure;
+}
+
+//---------------------------------------------------------
+// Function: ToneMap
+// Tone map one colour component to 0 - 1
+//   Reference for the conversion of half float formats.
+float spoutCopy::ToneMap(float value) const
+{
+	// Negative and NaN are zero
+	float x = (value > 0.0f) ? value*m_Exposure : 0.0f;
+	if (x > SPOUT_TONEMAP_LIMIT)
+		x = SPOUT_TONEMAP_LIMIT;
+	if (m_ToneMap == SPOUT_TONEMAP_REINHARD)
+		x = x/(1.0f + x);
+	else if (m_ToneMap == SPOUT_TONEMAP_ACES)
+		x = (x*(2.51f*x + 0.03f))/(x*(2.43f*x + 0.59f) + 0.14f);
+	return (x < 1.0f) ? x : 1.0f;
+}
+
+//---------------------------------------------------------
+// Function: SetColourAdjust
+// Colour adjustment of converted pixels
+//   Tables for bytes 0, 1 and 2 of each source pixel (nullptr for no change)
+//   and a 3x3 matrix of 9 floats by rows (nullptr for none).
+//   The matrix is applied first. Both are in the byte order of the source.
+//   Applied by rgba2rgb, rgba2rgba, rgba2bgra, the resample functions
+//   and format2rgba, in the SIMD kernels before packing or to each row
+//   immediately after it is copied.
+void spoutCopy::SetColourAdjust(const unsigned char* table0, const unsigned char* table1,
+	const unsigned char* table2, const float* matrix)
+{
+	const unsigned char* tables[3] = { table0, table1, table2 };
+	m_Adjust.bTables = false;
+	for (unsigned int c = 0; c < 3; c++) {
+		for (unsigned int v = 0; v < 256; v++) {
+			const unsigned char value = tables[c] ? tables[c][v] : (unsigned char)v;
+			m_Adjust.table[c][v] = value;
+			if (value != v)
+				m_Adjust.bTables = true;
+		}
+	}
+
+	// Matrix column for each source byte
+	m_Adjust.bMatrix = false;
+	memset(m_Adjust.columns, 0, sizeof(m_Adjust.columns));
+	if (matrix) {
+		for (unsigned int row = 0; row < 3; row++) {
+			for (unsigned int col = 0; col < 3; col++) {
+				const float value = matrix[row*3 + col];
+				m_Adjust.columns[col*4 + row] = value;
+				if (value != ((row == col) ? 1.0f : 0.0f))
+					m_Adjust.bMatrix = true;
+			}
+		}
+	}
+
+	m_bAdjust = (m_Adjust.bTables || m_Adjust.bMatrix);
+}
+
+//---------------------------------------------------------
+// Function: ClearColourAdjust
+// Remove colour adjustment
+void spoutCopy::ClearColourAdjust()
+{
+	m_bAdjust = false;
+	m_Adjust.bTables = false;
+	m_Adjust.bMatrix = false;
+}
+
+//---------------------------------------------------------
+// Function: GetColourAdjust
+// Return whether colour adjustment is applied
+bool spoutCopy::GetColourAdjust() const
+{
+	return m_bAdjust;
+}
+
+//---------------------------------------------------------
+// Function: AdjustColour
+// Adjust the colour of 8 bit rgba or rgb pixels in place
+//   Bytes 0 and 2 are in reverse order to the source if bSwapRB is set.
+void spoutCopy::AdjustColour(unsigned char* pixels, unsigned int width, unsigned int height,
+	unsigned int pitch, unsigned int bpp, bool bSwapRB) const
+{
+	if (!pixels || !m_bAdjust || (bpp != 3 && bpp != 4))
+		return;
+	for (unsigned int y = 0; y < height; y++)
+		AdjustRow(pixels + (size_t)y*pitch, width, bpp, bSwapRB);
+}
+
+//---------------------------------------------------------
+// Function: AdjustRow
+// Adjust the colour of one row of pixels in place
+//   Blocks of 4 pixels are adjusted together.
+void spoutCopy::AdjustRow(unsigned char* row, unsigned int width, unsigned int bpp, bool bSwapRB) const
+{
+	const unsigned int ir = bSwapRB ? 2 : 0;
+	const unsigned int ib = bSwapRB ? 0 : 2;
+
+	unsigned int x = 0;
+	if (bpp == 4) {
+		for (; x + 4 <= width; x += 4) {
+			__m128i* p = reinterpret_cast<__m128i*>(row + (size_t)x*4);
+			__m128i px = _mm_loadu_si128(p);
+			if (bSwapRB)
+				px = SwapRB(px);
+			px = AdjustPixels(px, m_Adjust);
+			if (bSwapRB)
+				px = SwapRB(px);
+			_mm_storeu_si128(p, px);
+		}
+	}
+	else {
+		alignas(16) unsigned char rgba[16]={};
+		for (; x + 4 <= width; x += 4) {
+			unsigned char* d = row + (size_t)x*3;
+			for (unsigned int i = 0; i < 4; i++) {
+				rgba[i*4 + 0] = d[i*3 + ir];
+				rgba[i*4 + 1] = d[i*3 + 1];
+				rgba[i*4 + 2] = d[i*3 + ib];
+			}
+			_mm_store_si128(reinterpret_cast<__m128i*>(rgba),
+				AdjustPixels(_mm_load_si128(reinterpret_cast<const __m128i*>(rgba)), m_Adjust));
+			for (unsigned int i = 0; i < 4; i++) {
+				d[i*3 + ir] = rgba[i*4 + 0];
+				d[i*3 + 1]  = rgba[i*4 + 1];
+				d[i*3 + ib] = rgba[i*4 + 2];
+			}
+		}
+	}
+
+	// Remaining pixels
+	for (; x < width; x++) {
+		unsigned char* d = row + (size_t)x*bpp;
+		unsigned char rgba[4] = { d[ir], d[1], d[ib], 0 };
+		AdjustPixel(rgba, m_Adjust);
+		d[ir] = rgba[0];
+		d[1]  = rgba[1];
+		d[ib] = rgba[2];
+	}
 }
 
 //---------------------------------------------------------
@@ -1584,6 +2835,11 @@ void spoutCopy::CheckSSE()
 		// SSSE3 | [bit 9] ECX
 		// SSSE3 = (cpuid02 & (0x1 << 9)
 		m_bSSSE3 = ((CPUInfo[2] & (0x1 << 9)) || false);
+		// F16C | [bit 29] ECX
+		// Also requires OS support for AVX registers
+		// OSXSAVE [bit 27] ECX and XCR0 bits 1 and 2
+		if ((CPUInfo[2] & (0x1 << 29)) && (CPUInfo[2] & (0x1 << 27)))
+			m_bF16C = ((_xgetbv(0) & 6) == 6);
 	}
 	#endif
 }
@@ -1799,3 +3055,175 @@ void spoutCopy::rgba_swap_ssse3(void* __restrict rgba_source, unsigned int width
     }
 
 } // end rgba_swap_ssse3
+
+//---------------------------------------------------------
+// Function: rgba_downsample_sse2
+// Box filter downsample of rgba pixels by an integer factor of 2 or 4
+// to rgba or rgb with flip, mirror and swap red/blue in the same pass.
+//   Each destination pixel is the average of a 2x2 or 4x4 block of
+//   source pixels, so there is less aliasing than the nearest pixel
+//   of the general resample functions. Pitches are in bytes.
+//   RGB packing requires SSSE3, otherwise the pixels are packed by byte.
+//   Converts destination rows y0 - y1 before flip.
+void spoutCopy::rgba_downsample_sse2(const void* source, void* dest,
+	unsigned int destWidth, unsigned int destHeight, unsigned int sourcePitch, unsigned int destPitch,
+	unsigned int factor, unsigned int y0, unsigned int y1,
+	bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const
+{
+	auto src = static_cast<const unsigned char*>(source);
+	auto dst = static_cast<unsigned char*>(dest);
+	if (!src || !dst || (factor != 2 && factor != 4))
+		return;
+	if (y1 > destHeight) y1 = destHeight;
+
+	const unsigned int bpp = bRGB ? 3 : 4;
+	const unsigned int blocks = destWidth/4; // 4 destination pixels for each block
+
+	// Swap red and blue option
+	const unsigned int ir = bSwapRB ? 2 : 0;
+	const unsigned int ib = bSwapRB ? 0 : 2;
+
+	// RGBA to RGB/BGR packing of 4 pixels (requires SSSE3)
+	const __m128i rgbmask = bSwapRB ?
+		_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+		_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+	// Colour adjustment (see SetColourAdjust)
+	const SpoutColourAdjust* adjust = m_bAdjust ? &m_Adjust : nullptr;
+
+	unsigned char pixels[4]={};
+
+	for (unsigned int y = y0; y < y1; y++) {
+
+		const unsigned char* row = src + (size_t)y*factor*sourcePitch;
+		const unsigned int dy = bInvert ? (destHeight - y - 1) : y;
+		unsigned char* drow = dst + (size_t)dy*destPitch;
+
+		for (unsigned int x = 0; x < blocks; x++) {
+			__m128i px = (factor == 2) ? Box2(row + x*32, sourcePitch) : Box4(row + x*64, sourcePitch);
+			if (adjust)
+				px = AdjustPixels(px, *adjust);
+			StorePixels(px, drow, x*4, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+		}
+
+		// Remaining pixels for widths not divisible by 4
+		for (unsigned int x = blocks*4; x < destWidth; x++) {
+			BoxPixel(row + (size_t)x*factor*4, sourcePitch, factor, pixels);
+			if (adjust)
+				AdjustPixel(pixels, *adjust);
+			const unsigned int dx = bMirror ? (destWidth - x - 1) : x;
+			unsigned char* d = drow + (size_t)dx*bpp;
+			d[ir] = pixels[0];
+			d[1]  = pixels[1];
+			d[ib] = pixels[2];
+			if (!bRGB)
+				d[3] = pixels[3];
+		}
+	}
+
+} // end rgba_downsample_sse2
+
+//---------------------------------------------------------
+// Function: rgba_upsample_sse2
+// Pixel replication upsample of rgba pixels by an integer factor
+// to rgba or rgb with flip, mirror and swap red/blue in the same pass.
+//   Each source row is expanded to one destination row, replicating
+//   pixels with 32 bit shuffles for factors 2 to 4. The other rows
+//   for the factor are copies of that row. Pitches are in bytes.
+//   Converts destination rows y0 - y1 before flip.
+void spoutCopy::rgba_upsample_sse2(const void* source, void* dest,
+	unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch, unsigned int destPitch,
+	unsigned int factor, unsigned int y0, unsigned int y1,
+	bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const
+{
+	auto src = static_cast<const unsigned char*>(source);
+	auto dst = static_cast<unsigned char*>(dest);
+	if (!src || !dst || factor < 2)
+		return;
+
+	const unsigned int bpp = bRGB ? 3 : 4;
+	const unsigned int destWidth = sourceWidth*factor;
+	const unsigned int destHeight = sourceHeight*factor;
+	const size_t rowbytes = (size_t)destWidth*bpp;
+	if (y1 > destHeight) y1 = destHeight;
+	if (y0 >= y1)
+		return;
+
+	// 4 source pixels for each block with shuffles up to factor 4
+	const unsigned int blocks = (factor <= 4) ? sourceWidth/4 : 0;
+
+	// Swap red and blue option
+	const unsigned int ir = bSwapRB ? 2 : 0;
+	const unsigned int ib = bSwapRB ? 0 : 2;
+
+	// RGBA to RGB/BGR packing of 4 pixels (requires SSSE3)
+	const __m128i rgbmask = bSwapRB ?
+		_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1) :
+		_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+	// Colour adjustment (see SetColourAdjust)
+	const SpoutColourAdjust* adjust = m_bAdjust ? &m_Adjust : nullptr;
+
+	for (unsigned int y = y0/factor; y*factor < y1; y++) {
+
+		const unsigned char* row = src + (size_t)y*sourcePitch;
+
+		// Destination rows for the source row within rows y0 - y1
+		const unsigned int first = (y*factor > y0) ? y*factor : y0;
+		const unsigned int last = ((y + 1)*factor < y1) ? (y + 1)*factor : y1;
+
+		// First and following destination rows after flip
+		const unsigned int dy = bInvert ? (destHeight - last) : first;
+		unsigned char* drow = dst + (size_t)dy*destPitch;
+
+		for (unsigned int x = 0; x < blocks; x++) {
+			__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x*16));
+			if (adjust)
+				px = AdjustPixels(px, *adjust);
+			const unsigned int dx = x*4*factor;
+			if (factor == 2) {
+				StorePixels(_mm_unpacklo_epi32(px, px), drow, dx, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+				StorePixels(_mm_unpackhi_epi32(px, px), drow, dx + 4, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+			}
+			else if (factor == 3) {
+				StorePixels(_mm_shuffle_epi32(px, _MM_SHUFFLE(1, 0, 0, 0)), drow, dx, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+				StorePixels(_mm_shuffle_epi32(px, _MM_SHUFFLE(2, 2, 1, 1)), drow, dx + 4, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+				StorePixels(_mm_shuffle_epi32(px, _MM_SHUFFLE(3, 3, 3, 2)), drow, dx + 8, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+			}
+			else {
+				StorePixels(_mm_shuffle_epi32(px, _MM_SHUFFLE(0, 0, 0, 0)), drow, dx, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+				StorePixels(_mm_shuffle_epi32(px, _MM_SHUFFLE(1, 1, 1, 1)), drow, dx + 4, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+				StorePixels(_mm_shuffle_epi32(px, _MM_SHUFFLE(2, 2, 2, 2)), drow, dx + 8, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+				StorePixels(_mm_shuffle_epi32(px, _MM_SHUFFLE(3, 3, 3, 3)), drow, dx + 12, destWidth, bRGB, bMirror, bSwapRB, m_bSSSE3, rgbmask);
+			}
+		}
+
+		// Remaining pixels and factors greater than 4
+		for (unsigned int x = blocks*4; x < sourceWidth; x++) {
+			unsigned char s[4]={};
+			memcpy(s, row + (size_t)x*4, 4);
+			if (adjust)
+				AdjustPixel(s, *adjust);
+			for (unsigned int i = 0; i < factor; i++) {
+				const unsigned int dx = bMirror ? (destWidth - x*factor - i - 1) : (x*factor + i);
+				unsigned char* d = drow + (size_t)dx*bpp;
+				d[ir] = s[0];
+				d[1]  = s[1];
+				d[ib] = s[2];
+				if (!bRGB)
+					d[3] = s[3];
+			}
+		}
+
+		// Copy the row for the remaining rows of the factor
+		// Use streaming stores if the rows are 16 byte aligned
+		for (unsigned int i = 1; i < last - first; i++) {
+			unsigned char* copy = drow + (size_t)i*destPitch;
+			if (((uintptr_t)drow % 16) == 0 && ((uintptr_t)copy % 16) == 0)
+				memcpy_sse2(copy, drow, rowbytes);
+			else
+				memcpy(copy, drow, rowbytes);
+		}
+	}
+
+} // end rgba_upsample_sse2
@@ -48,6 +48,22 @@
 #include <cmath> // For compatibility with Clang. PR#81
 #include <stdint.h> // for _uint32 etc
 
+// Tone mapping of half float formats (see SetToneMapping)
+#define SPOUT_TONEMAP_NONE     0 // Clamp to 0 - 1
+#define SPOUT_TONEMAP_REINHARD 1 // x/(1 + x)
+#define SPOUT_TONEMAP_ACES     2 // ACES filmic curve fit
+
+// Largest value before the curve so that infinity is mapped to 1
+#define SPOUT_TONEMAP_LIMIT    1.0e8f
+
+// Colour adjustment of 8 bit pixels (see SetColourAdjust)
+struct SpoutColourAdjust {
+	unsigned char table[3][256]; // Table for bytes 0, 1 and 2 of each pixel
+	float columns[12];           // Matrix column for each byte, 4 floats each
+	bool bTables;                // Tables are not identity
+	bool bMatrix;                // Matrix is not identity
+};
+
 class SPOUT_DLLEXP spoutCopy {
 
 	public:
@@ -82,6 +98,14 @@ class SPOUT_DLLEXP spoutCopy {
 		// SSE2 version of memcpy
 		void memcpy_sse2(void* dst, const void* src, size_t size) const;
 
+		// Fill pixels of 3 or 4 bytes with a colour using streaming stores
+		void FillPixels(unsigned char* dest, size_t count, unsigned int bpp,
+			const unsigned char* pixel) const;
+
+		// Hash of rows of pixel data to detect changes between frames
+		uint64_t HashRows(const void* source, unsigned int rowbytes,
+			unsigned int rows, unsigned int pitch) const;
+
 		//
 		// RGBA <> RGBA
 		//
@@ -99,6 +123,17 @@ class SPOUT_DLLEXP spoutCopy {
 			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
 			unsigned int destWidth, unsigned int destHeight, bool bInvert = false) const;
 
+		// Copy rgba buffers of differing size allowing for destination pitch
+		void rgba2rgbaResample(const void* source, void* dest,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight, unsigned int destPitch, bool bInvert) const;
+
+		// Destination rows y0 - y1 before flip
+		void rgba2rgbaResample(const void* source, void* dest,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+			unsigned int y0, unsigned int y1, bool bInvert) const;
+
 		//
 		// RGBA <> BGRA
 		//
@@ -141,6 +176,18 @@ class SPOUT_DLLEXP spoutCopy {
 			unsigned int destWidth, unsigned int destHeight,
 			bool bInvert = false, bool bMirror = false, bool bSwapRB = false) const;
 
+		// Copy RGBA to RGB allowing for source and destination pitch
+		void rgba2rgbResample(const void* source, void* dest,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+			bool bInvert, bool bMirror, bool bSwapRB) const;
+
+		// Destination rows y0 - y1 before flip
+		void rgba2rgbResample(const void* source, void* dest,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+			unsigned int y0, unsigned int y1, bool bInvert, bool bMirror, bool bSwapRB) const;
+
 		// Copy RGBA to BGR allowing for source and destination pitch
 		void rgba2bgrResample(const void* source, void* dest,
 			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
@@ -209,6 +256,52 @@ class SPOUT_DLLEXP spoutCopy {
 		// Copy BGRA to BGR
 		void bgra2bgr (const void* bgra_source, void *bgr_dest,  unsigned int width, unsigned int height, bool bInvert = false) const;
 
+		//
+		// 16 bit, half float and 10 bit formats to 8 bit
+		//
+		// Bytes for each pixel of a DXGI format that can be converted, otherwise zero
+		unsigned int FormatBytes(DWORD dxgiFormat) const;
+		// Convert to rgba or rgb with flip, mirror, swap red/blue and re-sample
+		bool format2rgba(const void* source, void* dest, DWORD dxgiFormat,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+			bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const;
+		// Destination rows y0 - y1 before flip
+		bool format2rgba(const void* source, void* dest, DWORD dxgiFormat,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+			unsigned int y0, unsigned int y1, bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const;
+		// Tone mapping of half float formats with exposure
+		void SetToneMapping(int mode, float exposure = 1.0f);
+		int GetToneMapping() const;
+		float GetExposure() const;
+		// Tone mapped component 0 - 1 (reference for the conversion)
+		float ToneMap(float value) const;
+
+		//
+		// Rotation
+		//
+		// Rotate 8 bit, 16 bit, half float or 10 bit pixels by 0, 90, 180 or 270 degrees
+		// clockwise to rgba or rgb, with flip, mirror, swap red/blue and re-sample.
+		// Destination rows y0 - y1 before flip.
+		bool rotate2rgba(const void* source, void* dest, DWORD dxgiFormat,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch,
+			unsigned int destWidth, unsigned int destHeight, unsigned int destPitch,
+			unsigned int rotation, unsigned int y0, unsigned int y1,
+			bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const;
+
+		//
+		// Colour adjustment
+		//
+		// Tables and 3x3 matrix in the byte order of the source pixels
+		void SetColourAdjust(const unsigned char* table0, const unsigned char* table1,
+			const unsigned char* table2, const float* matrix = nullptr);
+		void ClearColourAdjust();
+		bool GetColourAdjust() const;
+		// Adjust 8 bit rgba or rgb pixels in place
+		void AdjustColour(unsigned char* pixels, unsigned int width, unsigned int height,
+			unsigned int pitch, unsigned int bpp, bool bSwapRB) const;
+
 		// SSE capability
 		void GetSSE(bool &bSSE2, bool &bSSE3, bool &bSSSE3);
 		bool GetSSE2();
@@ -224,10 +317,31 @@ class SPOUT_DLLEXP spoutCopy {
 		bool m_bSSE2 = false;
 		bool m_bSSE3 = false;
 		bool m_bSSSE3 = false;
+		bool m_bF16C = false;
+		int m_ToneMap = SPOUT_TONEMAP_NONE;
+		float m_Exposure = 1.0f;
+		bool m_bAdjust = false;
+		SpoutColourAdjust m_Adjust = {};
+		// Adjust the colour of one row of pixels in place
+		void AdjustRow(unsigned char* row, unsigned int width, unsigned int bpp, bool bSwapRB) const;
 
 		void rgba_bgra(const void *rgba_source, void *bgra_dest, unsigned int width, unsigned int height, bool bInvert = false) const;
 		void rgba_bgra_sse2(const void *rgba_source, void *bgra_dest, unsigned int width, unsigned int height, bool bInvert = false) const;
 		void rgba_bgra_sse3(const void *rgba_source, void *bgra_dest, unsigned int width, unsigned int height, bool bInvert = false) const;
+
+		// Box filter downsample of rgba by 2 or 4 to rgba or rgb
+		// Destination rows y0 - y1 before flip
+		void rgba_downsample_sse2(const void* source, void* dest,
+			unsigned int destWidth, unsigned int destHeight, unsigned int sourcePitch, unsigned int destPitch,
+			unsigned int factor, unsigned int y0, unsigned int y1,
+			bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const;
+
+		// Pixel replication upsample of rgba by an integer factor to rgba or rgb
+		// Destination rows y0 - y1 before flip
+		void rgba_upsample_sse2(const void* source, void* dest,
+			unsigned int sourceWidth, unsigned int sourceHeight, unsigned int sourcePitch, unsigned int destPitch,
+			unsigned int factor, unsigned int y0, unsigned int y1,
+			bool bRGB, bool bInvert, bool bMirror, bool bSwapRB) const;
 		// LJ DEBUG
 		// void rgba_swap_ssse3(void* __restrict rgbasource, unsigned int width, unsigned int height);
 
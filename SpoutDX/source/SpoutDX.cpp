@@ -173,6 +173,38 @@
 //					  Include SpoutDXshaders.hpp in SpoutDX.h
 //					  ReadTexurePixels - remove staging texture check before global size update
 //		23.07.25	- Add conditional #include "SpoutDXshaders.hpp"
+//		19.10.26	- Add GetSenderLatency
+//					- Add WaitNewFrame
+//					- Add GetSenderFrameJitter, GetSenderFrameIntervalMin/Max
+//					  and GetSenderBurstCount
+//					- ReceiveImage, ReadPixelData - add timing probes
+//					  Remove debug timing code and variables
+//					- Add SetRowScheduler, ConvertRows and ReadPixelRows
+//					  ReadPixelData - same size conversions in bands of rows
+//					- Add SetFrameCache
+//					  ReceiveImage - copy converted pixels from the frame cache
+//					- Add SetChangeDetection, GetChangeCounts and ConvertChangedRows
+//					  ReadPixelData - same size conversions of changed rows only
+//					- Add SetFitMode and SetBorderColour
+//					  ReadPixelData - letterbox or crop for a different size
+//					- Add SetSourceRegion and GetSourceRegion
+//					  ReceiveImage - staging textures of the region size
+//					  ReadPixelData - use the staging texture size
+//					- Add ReadFormatRows
+//					  ReadPixelData - convert 16 bit, half float and 10 bit
+//					  staging textures on the CPU without shaders
+//					- Add SetToneMapping, GetToneMapping and GetExposure
+//					  for half float senders converted on the CPU
+//					- Add SetColourAdjust, SetColourTables, ClearColourAdjust
+//					  and GetColourAdjust. Applied by the pixel conversion.
+//					  ReceiveImage - adjusted frames are not cached
+//					- Add SetRotation, GetRotation and ReadRotatedRows
+//					  ReadPixelData - rotate 90, 180 or 270 degrees
+//					- Add SetTimecode and GetTimecode
+//					  ReceiveImage - timecode watermark of the staged frame
+//					- Add SetNominalFps
+//					- ReadPixelData, ReadFormatRows, ResampleFit - re-sample
+//					  in bands of destination rows with the row scheduler
 //
 // ====================================================================================
 /*
@@ -778,8 +810,12 @@ void spoutDX::ReleaseReceiver()
 	spoutdx.ReleaseDX11Texture(m_pd3dDevice, m_pStaging[1]);
 	m_pStaging[0] = nullptr;
 	m_pStaging[1] = nullptr;
+	m_StagingFrame[0] = 0;
+	m_StagingFrame[1] = 0;
 	m_Index = 0;
 	m_NextIndex = 0;
+	m_pChangeDest = nullptr;
+	m_BorderBuffers.clear();
 
 	// Flush now to avoid deferred object destruction
 	if (m_pImmediateContext) m_pImmediateContext->Flush();
@@ -972,6 +1008,8 @@ bool spoutDX::ReceiveImage(unsigned char* pixels,
 			//     DXGI_FORMAT_R16G16B16A16_FLOAT  (10)
 			//     DXGI_FORMAT_R16G16B16A16_SNORM  (13)
 			//     DXGI_FORMAT_R10G10B10A2_UNORM   (24)
+			// Without shaders, the 16 bit, half float and 10 bit formats
+			// are converted on the CPU by ReadPixelData (see ReadFormatRows)
 			//
 			#ifdef __spoutDXshaders__
 			spoutdx.CreateDX11Texture(m_pd3dDevice,
@@ -987,8 +1025,14 @@ bool spoutDX::ReceiveImage(unsigned char* pixels,
 			#endif
 
 			// The staging textures must be the same size and format as the sender
-			// Create new staging textures if it is a different size or format
-			CheckStagingTextures(m_Width, m_Height, m_dwFormat);
+			// or the region received. Create new staging textures if it is a
+			// different size or format
+			D3D11_BOX box={};
+			GetSenderRegion(box);
+			CheckStagingTextures(box.right - box.left, box.bottom - box.top, m_dwFormat);
+			m_StagingFrame[0] = 0;
+			m_StagingFrame[1] = 0;
+			m_pChangeDest = nullptr;
 
 			// The application detects the change with IsUpdated()
 			// and the receiving buffer can be updated to match the sender.
@@ -1000,6 +1044,11 @@ bool spoutDX::ReceiveImage(unsigned char* pixels,
 		if (!pixels)
 			return false;
 
+		// Staging textures for a change of the region received
+		D3D11_BOX box={};
+		const bool bRegion = GetSenderRegion(box);
+		CheckStagingTextures(box.right - box.left, box.bottom - box.top, m_dwFormat);
+
 		// No staging textures - no copy
 		if (!m_pStaging[0] || !m_pStaging[1])
 			return false;
@@ -1008,8 +1057,8 @@ bool spoutDX::ReceiveImage(unsigned char* pixels,
 		// Found a sender
 		//
 
-		// LJ DEBUG
-		// StartTiming();
+		// Time the copy to pixels if timing is enabled
+		SPOUT_TIMING("spoutDX::ReceiveImage");
 
 		// Access the sender shared texture
 		if (frame.CheckTextureAccess(m_pSharedTexture)) {
@@ -1023,6 +1072,23 @@ bool spoutDX::ReceiveImage(unsigned char* pixels,
 				m_Index = (m_Index + 1) % 2;
 				m_NextIndex = (m_Index + 1) % 2;
 
+				// Sender frame number copied to the staging texture
+				// Zero if the sender does not write extended information
+				SharedTextureInfoEx info{};
+				m_StagingFrame[m_Index] = 0;
+				const bool bFrameInfo = (m_pFrameCache || m_bTimecode) && frame.GetSenderFrameInfo(info);
+				if (m_pFrameCache && bFrameInfo)
+					m_StagingFrame[m_Index] = info.frameCount;
+
+				// Frame number and capture time for the timecode watermark.
+				// The received frame count and the time of the copy
+				// if the sender does not write extended information.
+				if (m_bTimecode) {
+					m_TimecodeFrame[m_Index] = bFrameInfo ? info.frameCount : static_cast<uint64_t>(frame.GetSenderFrame());
+					m_TimecodeTime[m_Index] = (bFrameInfo && info.timestamp > 0) ? info.timestamp
+						: static_cast<uint64_t>(GetCounterMicroseconds());
+				}
+
 				// If the format is not BGRA, a class texture of BGRA format
 				// will have been produced. Copy from the received texture to that.
 				#ifdef __spoutDXshaders__
@@ -1040,19 +1106,73 @@ bool spoutDX::ReceiveImage(unsigned char* pixels,
 					if (m_bSwapRB)
 						shaders.Swap(m_pTexture, DXGI_FORMAT_B8G8R8A8_UNORM, m_Width, m_Height);
 					// Copy to the RGBA staging texture
-					m_pImmediateContext->CopyResource(m_pStaging[m_Index], m_pTexture);
+					if (bRegion) {
+						// The region is flipped and mirrored with the texture
+						D3D11_BOX texbox = box;
+						if (bInvert) {
+							texbox.top = m_Height - box.bottom;
+							texbox.bottom = m_Height - box.top;
+						}
+						if (m_bMirror) {
+							texbox.left = m_Width - box.right;
+							texbox.right = m_Width - box.left;
+						}
+						m_pImmediateContext->CopySubresourceRegion(m_pStaging[m_Index], 0, 0, 0, 0, m_pTexture, 0, &texbox);
+					}
+					else {
+						m_pImmediateContext->CopyResource(m_pStaging[m_Index], m_pTexture);
+					}
 				}
 				#else
 					// Copy from the sender's shared texture
-					m_pImmediateContext->CopyResource(m_pStaging[m_Index], m_pSharedTexture);
+					if (bRegion)
+						m_pImmediateContext->CopySubresourceRegion(m_pStaging[m_Index], 0, 0, 0, 0, m_pSharedTexture, 0, &box);
+					else
+						m_pImmediateContext->CopyResource(m_pStaging[m_Index], m_pSharedTexture);
 				#endif
 					// Copy to pixels rgb or rgba
 					// Invert and swap are done for shaders
 					// Destination resolution can be different for SpoutCam
-					if(m_pTexture)
-						ReadPixelData(m_pStaging[m_NextIndex], pixels, width, height, bRGB, false, false);
-					else
-						ReadPixelData(m_pStaging[m_NextIndex], pixels, width, height, bRGB, bInvert, m_bSwapRB);
+					// Use pixels from the frame cache if another receiver
+					// has converted the staged frame in the same way.
+					// Conversion code : tone mapping, staging format, rotation, fit, rgb, invert, mirror, swap
+					// Borders of a colour other than black, regions and colour
+					// adjusted frames are not shared.
+					const uint64_t stagedframe = m_StagingFrame[m_NextIndex];
+					const DWORD conversion = GetToneCode() | (m_dwFormat << 8) | ((m_Rotation/90) << 6) | (m_FitMode << 4)
+						| (bRGB ? 1 : 0) | (bInvert ? 2 : 0) | (m_bMirror ? 4 : 0) | (m_bSwapRB ? 8 : 0);
+					const unsigned int size = width*height*(bRGB ? 3 : 4);
+					SpoutFrameCache* pCache = m_pFrameCache;
+					if ((m_FitMode == SPOUT_FIT_LETTERBOX && m_BorderColour != 0) || bRegion || m_bColourAdjust)
+						pCache = nullptr;
+					if (!pCache || stagedframe == 0
+						|| !pCache->Read(m_SenderName, stagedframe, conversion, width, height, pixels, size)) {
+						bool bRead = false;
+						if(m_pTexture)
+							bRead = ReadPixelData(m_pStaging[m_NextIndex], pixels, width, height, bRGB, false, false);
+						else
+							bRead = ReadPixelData(m_pStaging[m_NextIndex], pixels, width, height, bRGB, bInvert, m_bSwapRB);
+						if (bRead && pCache && stagedframe > 0)
+							pCache->Write(m_SenderName, stagedframe, conversion, width, height, pixels, size);
+					}
+					else {
+						// The pixels are no longer the last conversion
+						m_pChangeDest = nullptr;
+					}
+					// Timecode in the top left corner of the image as displayed.
+					// After the frame cache so that cached frames have no timecode.
+					if (m_bTimecode) {
+						const unsigned int bpp = bRGB ? 3 : 4;
+						unsigned char* top = pixels;
+						ptrdiff_t pitch = static_cast<ptrdiff_t>(width*bpp);
+						if (bInvert) {
+							top = pixels + (height - 1)*width*bpp;
+							pitch = -pitch;
+						}
+						SpoutTimecodeWrite(top, width, height, pitch, bpp,
+							static_cast<uint32_t>(m_TimecodeFrame[m_NextIndex]),
+							m_TimecodeTime[m_NextIndex], m_TimecodeCell);
+					}
 			} // endif new frame
 
 			// Allow access to the shared texture
@@ -1060,20 +1180,6 @@ bool spoutDX::ReceiveImage(unsigned char* pixels,
 
 		} // endif allow access
 
-		/*
-		// LJ DEBUG
-		double timing = EndTiming();
-		timingSum += timing;
-		timingNum += 1.0;
-		timingAvg = timingSum/timingNum;
-		if (m_pTexture) {
-			printf("Shader copy = %.3f - avg = %.3f\n", timing, timingAvg);
-		}
-		else {
-			printf("Copy time = %.3f - avg = %.3f\n", timing, timingAvg);
-		}
-		*/
-
 		m_bConnected = true;
 
 	} // sender exists
@@ -1300,6 +1406,63 @@ long spoutDX::GetSenderFrame()
 	return frame.GetSenderFrame();
 }
 
+//---------------------------------------------------------
+// Function: GetSenderLatency
+//   Sender capture to receive latency (msec)
+//   Requires extended sender frame information
+double spoutDX::GetSenderLatency()
+{
+	return frame.GetSenderLatency();
+}
+
+//---------------------------------------------------------
+// Function: GetSenderFrameJitter
+//   Sender frame interval jitter (msec)
+//   Standard deviation of frame intervals over the last second
+double spoutDX::GetSenderFrameJitter()
+{
+	return frame.GetSenderFrameJitter();
+}
+
+//---------------------------------------------------------
+// Function: GetSenderFrameIntervalMin
+//   Sender minimum frame interval over the last second (msec)
+double spoutDX::GetSenderFrameIntervalMin()
+{
+	return frame.GetSenderFrameIntervalMin();
+}
+
+//---------------------------------------------------------
+// Function: GetSenderFrameIntervalMax
+//   Sender maximum frame interval over the last second (msec)
+double spoutDX::GetSenderFrameIntervalMax()
+{
+	return frame.GetSenderFrameIntervalMax();
+}
+
+//---------------------------------------------------------
+// Function: GetSenderBurstCount
+//   Number of frames received less than half
+//   the typical frame interval after the last
+long spoutDX::GetSenderBurstCount()
+{
+	return frame.GetSenderBurstCount();
+}
+
+//---------------------------------------------------------
+// Function: WaitNewFrame
+//   Wait until the sender signals a new frame or the timeout elapses.
+//   Returns true for a new frame. If not connected, or the sender does
+//   not signal new frames, waits for the full timeout and returns false.
+bool spoutDX::WaitNewFrame(DWORD dwTimeout)
+{
+	if (!m_bSpoutInitialized) {
+		if (dwTimeout > 0) Sleep(dwTimeout);
+		return false;
+	}
+	return frame.WaitNewFrame(dwTimeout);
+}
+
 
 //---------------------------------------------------------
 // COMMON
@@ -1318,6 +1481,16 @@ void spoutDX::HoldFps(int fps)
 	frame.HoldFps(fps);
 }
 
+//---------------------------------------------------------
+// Function: SetNominalFps
+// Nominal sender frame rate
+//    Written to the sender frame information for receivers.
+//    HoldFps also sets it. Zero if unknown.
+void spoutDX::SetNominalFps(double fps)
+{
+	frame.SetNominalFps(fps);
+}
+
 // Function: DisableFrameCount
 // Disable frame counting specifically for this application
 void spoutDX::DisableFrameCount()
@@ -2093,6 +2266,304 @@ bool spoutDX::GetSwap()
 	return m_bSwapRB;
 }
 
+//---------------------------------------------------------
+// Function: SetRowScheduler
+// Set a scheduler for pixel conversion
+//   Conversions by ReadPixelData are divided into bands of rows
+//   and run by the scheduler. The scheduler can be shared
+//   by multiple receivers. Set nullptr to convert on the calling thread.
+void spoutDX::SetRowScheduler(SpoutRowScheduler* pScheduler)
+{
+	m_pRowScheduler = pScheduler;
+}
+
+//---------------------------------------------------------
+// Function: SetFrameCache
+// Set a cache of converted frames
+//   ReceiveImage copies the pixels of a sender frame from the cache
+//   if another receiver has converted it in the same way, and saves
+//   the pixels after conversion. Requires the sender frame number
+//   from extended sender information (see SpoutFrameCount).
+void spoutDX::SetFrameCache(SpoutFrameCache* pCache)
+{
+	m_pFrameCache = pCache;
+}
+
+//---------------------------------------------------------
+// Function: SetChangeDetection
+// Convert only rows that have changed since the last frame
+//   Same size conversions by ReadPixelData compare a hash of each band
+//   of staging texture rows with the last frame. Unchanged bands are
+//   not converted if the destination is the same pixel buffer, which
+//   must not be modified by the application between frames.
+void spoutDX::SetChangeDetection(bool bDetect)
+{
+	m_bChangeDetect = bDetect;
+	m_pChangeDest = nullptr;
+}
+
+//---------------------------------------------------------
+// Function: GetChangeDetection
+// Return change detection option
+bool spoutDX::GetChangeDetection()
+{
+	return m_bChangeDetect;
+}
+
+//---------------------------------------------------------
+// Function: SetFitMode
+// Fit of the sender to a different receiving size
+//   SPOUT_FIT_STRETCH   - fill the receiving size (default)
+//   SPOUT_FIT_LETTERBOX - whole sender with borders of the border colour
+//   SPOUT_FIT_CROP      - fill the receiving size and crop the sender
+//   The aspect ratio of the sender is kept for letterbox and crop.
+void spoutDX::SetFitMode(int mode)
+{
+	if (mode < SPOUT_FIT_STRETCH || mode > SPOUT_FIT_CROP)
+		mode = SPOUT_FIT_STRETCH;
+	m_FitMode = mode;
+}
+
+//---------------------------------------------------------
+// Function: GetFitMode
+// Return fit mode
+int spoutDX::GetFitMode()
+{
+	return m_FitMode;
+}
+
+//---------------------------------------------------------
+// Function: SetBorderColour
+// Letterbox border colour (0xRRGGBB, default black)
+void spoutDX::SetBorderColour(DWORD colour)
+{
+	m_BorderColour = (colour & 0xFFFFFF);
+}
+
+//---------------------------------------------------------
+// Function: GetBorderColour
+// Return letterbox border colour
+DWORD spoutDX::GetBorderColour()
+{
+	return m_BorderColour;
+}
+
+//---------------------------------------------------------
+// Function: SetToneMapping
+// Tone mapping of half float senders (DXGI_FORMAT_R16G16B16A16_FLOAT)
+//   SPOUT_TONEMAP_NONE     - clamp to 0 - 1 (default)
+//   SPOUT_TONEMAP_REINHARD - x/(1 + x)
+//   SPOUT_TONEMAP_ACES     - ACES filmic curve fit
+//   Colour is multiplied by the exposure before the curve.
+//   Applied by the CPU conversion without shaders (see ReadFormatRows).
+void spoutDX::SetToneMapping(int mode, float exposure)
+{
+	spoutcopy.SetToneMapping(mode, exposure);
+}
+
+//---------------------------------------------------------
+// Function: GetToneMapping
+// Return tone mapping mode
+int spoutDX::GetToneMapping()
+{
+	return spoutcopy.GetToneMapping();
+}
+
+//---------------------------------------------------------
+// Function: GetExposure
+// Return tone mapping exposure
+float spoutDX::GetExposure()
+{
+	return spoutcopy.GetExposure();
+}
+
+//---------------------------------------------------------
+// Function: SetColourAdjust
+// Colour adjustment of received pixels
+//   brightness - added to colour, -1 to 1 (default 0)
+//   contrast   - multiplied about mid grey (default 1)
+//   gamma      - greater than 1 to lighten (default 1)
+//   saturation - 0 for grey, greater than 1 to increase (default 1)
+//   black      - input black level 0-255 (default 0)
+//   white      - input white level 0-255 (default 255)
+//   Levels, gamma, contrast and brightness are built into a table
+//   for each channel. Saturation is a colour matrix applied before
+//   the tables. Both are applied by the pixel conversion functions
+//   without an extra pass. Default values remove the adjustment.
+void spoutDX::SetColourAdjust(float brightness, float contrast, float gamma,
+	float saturation, unsigned int black, unsigned int white)
+{
+	if (white > 255) white = 255;
+	if (black >= white) black = (white > 0) ? white - 1 : 0;
+	const float range = (float)(white - black);
+
+	unsigned char table[256]{};
+	for (unsigned int v = 0; v < 256; v++) {
+		float x = ((float)v - (float)black)/range;
+		if (x < 0.0f) x = 0.0f;
+		if (x > 1.0f) x = 1.0f;
+		if (gamma > 0.0f && gamma != 1.0f)
+			x = powf(x, 1.0f/gamma);
+		x = (x - 0.5f)*contrast + 0.5f + brightness;
+		if (x < 0.0f) x = 0.0f;
+		if (x > 1.0f) x = 1.0f;
+		table[v] = (unsigned char)(x*255.0f + 0.5f);
+	}
+
+	// Saturation matrix about Rec.709 luma
+	float matrix[9]{};
+	const float luma[3] = { 0.2126f, 0.7152f, 0.0722f };
+	for (unsigned int row = 0; row < 3; row++) {
+		for (unsigned int col = 0; col < 3; col++)
+			matrix[row*3 + col] = (1.0f - saturation)*luma[col] + ((row == col) ? saturation : 0.0f);
+	}
+
+	SetColourTables(table, table, table, saturation != 1.0f ? matrix : nullptr);
+}
+
+//---------------------------------------------------------
+// Function: SetColourTables
+// Colour adjustment by tables and matrix
+//   red, green, blue - 256 entry tables for each channel
+//   matrix           - 3x3 RGB colour matrix by rows
+//   The matrix is applied before the tables.
+//   A null table or matrix is not applied.
+void spoutDX::SetColourTables(const unsigned char* red, const unsigned char* green,
+	const unsigned char* blue, const float* matrix)
+{
+	const unsigned char* tables[3] = { red, green, blue };
+	bool bTables = false;
+	for (unsigned int c = 0; c < 3; c++) {
+		for (unsigned int v = 0; v < 256; v++) {
+			m_ColourTable[c][v] = tables[c] ? tables[c][v] : (unsigned char)v;
+			if (m_ColourTable[c][v] != v)
+				bTables = true;
+		}
+	}
+
+	m_bColourMatrix = false;
+	for (unsigned int i = 0; i < 9; i++) {
+		m_ColourMatrix[i] = matrix ? matrix[i] : ((i % 4 == 0) ? 1.0f : 0.0f);
+		if (m_ColourMatrix[i] != ((i % 4 == 0) ? 1.0f : 0.0f))
+			m_bColourMatrix = true;
+	}
+
+	m_bColourAdjust = (bTables || m_bColourMatrix);
+	// Apply with the next frame and convert all rows
+	m_ColourOrder = -1;
+	m_pChangeDest = nullptr;
+}
+
+//---------------------------------------------------------
+// Function: ClearColourAdjust
+// Remove colour adjustment
+void spoutDX::ClearColourAdjust()
+{
+	SetColourTables(nullptr, nullptr, nullptr);
+}
+
+//---------------------------------------------------------
+// Function: GetColourAdjust
+// Return whether colour adjustment is set
+bool spoutDX::GetColourAdjust()
+{
+	return m_bColourAdjust;
+}
+
+//---------------------------------------------------------
+// Function: SetRotation
+// Clockwise rotation of received pixels
+//   0, 90, 180 or 270 degrees, other values are not rotated.
+//   Rotation is done by the pixel conversion before flip and mirror.
+//   The receiving size for 90 and 270 degrees is normally
+//   the sender height by the sender width.
+void spoutDX::SetRotation(unsigned int degrees)
+{
+	if (degrees != 90 && degrees != 180 && degrees != 270)
+		degrees = 0;
+	m_Rotation = degrees;
+}
+
+//---------------------------------------------------------
+// Function: GetRotation
+// Return rotation in degrees
+unsigned int spoutDX::GetRotation()
+{
+	return m_Rotation;
+}
+
+//---------------------------------------------------------
+// Function: SetTimecode
+// Timecode watermark of received pixels
+//   ReceiveImage writes a block of cells with the sender frame number
+//   and capture time to the top left corner of the image. The receiving
+//   application records the time each frame arrives and SpoutTimecodeRead
+//   recovers the frame and capture time to find the latency.
+//   The capture time is the sender time stamp if the sender writes
+//   extended frame information, otherwise the time of the copy
+//   to the staging texture. Cell size is in pixels.
+void spoutDX::SetTimecode(bool bTimecode, unsigned int cell)
+{
+	if (cell == 0)
+		cell = SPOUT_TIMECODE_CELL;
+	m_bTimecode = bTimecode;
+	m_TimecodeCell = cell;
+	// Rows not converted by change detection and
+	// letterbox borders not filled again could retain the block
+	m_pChangeDest = nullptr;
+	m_BorderBuffers.clear();
+}
+
+//---------------------------------------------------------
+// Function: GetTimecode
+// Return whether the timecode watermark is enabled
+bool spoutDX::GetTimecode()
+{
+	return m_bTimecode;
+}
+
+//---------------------------------------------------------
+// Function: SetSourceRegion
+// Region of the sender to receive
+//   ReceiveImage copies only the region to staging textures of the
+//   region size, so the cost of conversion depends on the region and
+//   not the whole sender. The region is limited to the sender size.
+//   Zero width or height for the whole sender (default).
+void spoutDX::SetSourceRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	m_Region[0] = x;
+	m_Region[1] = y;
+	m_Region[2] = width;
+	m_Region[3] = height;
+}
+
+//---------------------------------------------------------
+// Function: GetSourceRegion
+// Return the region of the sender set by SetSourceRegion
+void spoutDX::GetSourceRegion(unsigned int &x, unsigned int &y, unsigned int &width, unsigned int &height)
+{
+	x = m_Region[0];
+	y = m_Region[1];
+	width = m_Region[2];
+	height = m_Region[3];
+}
+
+//---------------------------------------------------------
+// Function: GetChangeCounts
+// Frames checked for change and conversion avoided
+//   frames         - frames checked
+//   skippedframes  - frames not converted because nothing changed
+//   convertedbands - bands of rows converted
+//   skippedbands   - bands of rows not converted
+void spoutDX::GetChangeCounts(long long &frames, long long &skippedframes,
+	long long &convertedbands, long long &skippedbands)
+{
+	frames = m_ChangeFrames;
+	skippedframes = m_SkippedFrames;
+	convertedbands = m_ConvertedBands;
+	skippedbands = m_SkippedBands;
+}
+
 
 //
 // Sharing modes
@@ -2620,9 +3091,21 @@ bool spoutDX::ReadPixelData(ID3D11Texture2D* pStagingSource, unsigned char* dest
 	if (!m_pImmediateContext || !pStagingSource || !destpixels)
 		return false;
 
+	SPOUT_TIMING("spoutDX::ReadPixelData");
+
+	// Colour adjustment tables for the staging texture format
+	UpdateColourAdjust();
+
 	// printf("ReadPixelData width=%d, height = %d, m_Width = %d, m_Height = %d m_dwFormat = %d, bRGB = %d\n",
 				// width, height, m_Width, m_Height, m_dwFormat, bRGB);
 
+	// Size of the staging texture
+	// The sender or a region of it (see SetSourceRegion)
+	D3D11_TEXTURE2D_DESC desc={};
+	pStagingSource->GetDesc(&desc);
+	m_ReadWidth = desc.Width;
+	m_ReadHeight = desc.Height;
+
 	// Map the staging texture resource so we can access the pixels
 	D3D11_MAPPED_SUBRESOURCE mappedSubResource={};
 	// Make sure all commands are done before mapping the staging texture
@@ -2630,24 +3113,62 @@ bool spoutDX::ReadPixelData(ID3D11Texture2D* pStagingSource, unsigned char* dest
 	// Map waits for GPU access
 	const HRESULT hr = m_pImmediateContext->Map(pStagingSource, 0, D3D11_MAP_READ, 0, &mappedSubResource);
 	if (SUCCEEDED(hr)) {
+		// Re-sampled pixels are not the last same size conversion
+		if (width != m_ReadWidth || height != m_ReadHeight)
+			m_pChangeDest = nullptr;
 		// Copy the staging texture pixels to the user buffer
-		if (!bRGB) {
+		if (m_Rotation != 0) {
+			// Rotate in the same pass as the conversion
+			ReadRotatedRows(mappedSubResource.pData, mappedSubResource.RowPitch, destpixels,
+				width, height, bRGB, bInvert, bSwap);
+		}
+		else if ((width != m_ReadWidth || height != m_ReadHeight) && m_FitMode != SPOUT_FIT_STRETCH) {
+			// Re-sample for different dimensions with letterbox or crop
+			ResampleFit(mappedSubResource.pData, mappedSubResource.RowPitch, destpixels,
+				width, height, bRGB, bInvert, bSwap);
+		}
+		else if (spoutcopy.FormatBytes(m_dwFormat) > 0) {
+			//
+			// 16 bit, half float or 10 bit texture to 8 bit pixels
+			// DXGI_FORMAT_R16G16B16A16_FLOAT, R16G16B16A16_UNORM,
+			// R16G16B16A16_SNORM and R10G10B10A2_UNORM
+			// Component order is RGBA, as for DXGI_FORMAT_R8G8B8A8_UNORM
+			// RGBA texture > RGBA or BGR pixels, BGRA or RGB if swap
+			//
+			ReadFormatRows(mappedSubResource.pData, mappedSubResource.RowPitch, destpixels,
+				width, height, bRGB, bInvert, bSwap);
+		}
+		else if (!bRGB) {
 			//
 			// RGBA pixel buffer
 			//
 			// TODO : test rgba-rgba resample
 			// TODO : rgba2bgraResample
-			if (width != m_Width || height != m_Height) {
-				spoutcopy.rgba2rgbaResample(mappedSubResource.pData, destpixels, m_Width, m_Height,
-					mappedSubResource.RowPitch, width, height, bInvert);
+			if (width != m_ReadWidth || height != m_ReadHeight) {
+				// Destination rows y0 - y1
+				const void* source = mappedSubResource.pData;
+				const unsigned int pitch = mappedSubResource.RowPitch;
+				ConvertRows(height, [&](unsigned int y0, unsigned int y1) {
+					spoutcopy.rgba2rgbaResample(source, destpixels, m_ReadWidth, m_ReadHeight,
+						pitch, width, height, width*4, y0, y1, bInvert);
+				});
 			}
 			else {
 				// Copy rgba to rgba/bgra line by line allowing for source pitch using the fastest method
-				if (bSwap)
-					// Uses SSE3 copy function if line data is 16bit aligned (see SpoutCopy.cpp)
-					spoutcopy.rgba2bgra(mappedSubResource.pData, destpixels, width, height, mappedSubResource.RowPitch, bInvert);
-				else
-					spoutcopy.rgba2rgba(mappedSubResource.pData, destpixels, width, height, mappedSubResource.RowPitch, bInvert);
+				// Destination rows y0 - y1. The source rows are reversed if inverted.
+				const unsigned char* source = static_cast<const unsigned char*>(mappedSubResource.pData);
+				const unsigned int pitch = mappedSubResource.RowPitch;
+				const DWORD conversion = (m_dwFormat << 8) | (bInvert ? 2 : 0) | (bSwap ? 8 : 0);
+				ConvertChangedRows(source, pitch, destpixels, conversion, bInvert, [&](unsigned int y0, unsigned int y1) {
+					const unsigned int sy = bInvert ? (height - y1) : y0;
+					if (bSwap)
+						// Uses SSE3 copy function if line data is 16bit aligned (see SpoutCopy.cpp)
+						spoutcopy.rgba2bgra(source + (size_t)sy*pitch, destpixels + (size_t)y0*width*4,
+							width, y1 - y0, pitch, bInvert);
+					else
+						spoutcopy.rgba2rgba(source + (size_t)sy*pitch, destpixels + (size_t)y0*width*4,
+							width, y1 - y0, pitch, bInvert);
+				});
 			}
 		}
 		// RGB/BGR pixel buffer
@@ -2659,17 +3180,20 @@ bool spoutDX::ReadPixelData(ID3D11Texture2D* pStagingSource, unsigned char* dest
 			// if swap RGBA texture > RGB pixels
 			//
 			// If the texture format is RGBA it has to be converted to RGB/BGR by the staging texture copy
-			if (width != m_Width || height != m_Height) {
-				spoutcopy.rgba2rgbResample(mappedSubResource.pData, destpixels, m_Width, m_Height, mappedSubResource.RowPitch,
-					width, height, bInvert, m_bMirror, !bSwap);
+			if (width != m_ReadWidth || height != m_ReadHeight) {
+				// Destination rows y0 - y1
+				const void* source = mappedSubResource.pData;
+				const unsigned int pitch = mappedSubResource.RowPitch;
+				ConvertRows(height, [&](unsigned int y0, unsigned int y1) {
+					spoutcopy.rgba2rgbResample(source, destpixels, m_ReadWidth, m_ReadHeight, pitch,
+						width, height, width*3, y0, y1, bInvert, m_bMirror, !bSwap);
+				});
 			}
 			else {
 				// TODO - test reverse swap flag
 				// Copy RGBA to RGB or BGR allowing for source line pitch using the fastest method
 				// Uses SSE3 conversion functions if data is 16bit aligned (see SpoutCopy.cpp)
-				spoutcopy.rgba2rgb(mappedSubResource.pData, destpixels, m_Width, m_Height,
-					// mappedSubResource.RowPitch, bInvert, m_bMirror, !bSwap); // reverse swap flag for RGBA
-					mappedSubResource.RowPitch, bInvert, m_bMirror, bSwap);
+				ReadPixelRows(mappedSubResource.pData, destpixels, mappedSubResource.RowPitch, bInvert, bSwap);
 			}
 		}
 		else { // BGRA texture - DXGI_FORMAT_B8G8R8A8_UNORM (0x57, 87) - default
@@ -2679,16 +3203,20 @@ bool spoutDX::ReadPixelData(ID3D11Texture2D* pStagingSource, unsigned char* dest
 			// default BGRA texture > BGR pixels
 			// if swap BGRA texture > RGB pixels
 			//
-			if (width != m_Width || height != m_Height) {
+			if (width != m_ReadWidth || height != m_ReadHeight) {
 				// Re-sample for different dimensions
-				spoutcopy.rgba2rgbResample(mappedSubResource.pData, destpixels, m_Width, m_Height,
-					mappedSubResource.RowPitch, width, height, bInvert, m_bMirror, bSwap);
+				// Destination rows y0 - y1
+				const void* source = mappedSubResource.pData;
+				const unsigned int pitch = mappedSubResource.RowPitch;
+				ConvertRows(height, [&](unsigned int y0, unsigned int y1) {
+					spoutcopy.rgba2rgbResample(source, destpixels, m_ReadWidth, m_ReadHeight,
+						pitch, width, height, width*3, y0, y1, bInvert, m_bMirror, bSwap);
+				});
 			}
 			else {
 				// SSE3 approx 2.5 msec at 1920x1080, 1 msec at 1280x720
 				// Byte copy approx 9 msec at 1920x1080, 4 msec at 1280x720
-				spoutcopy.rgba2rgb(mappedSubResource.pData, destpixels, m_Width, m_Height,
-					mappedSubResource.RowPitch, bInvert, m_bMirror, bSwap);
+				ReadPixelRows(mappedSubResource.pData, destpixels, mappedSubResource.RowPitch, bInvert, bSwap);
 			}
 		}
 
@@ -2700,6 +3228,416 @@ bool spoutDX::ReadPixelData(ID3D11Texture2D* pStagingSource, unsigned char* dest
 
 } // end ReadPixelData
 
+//---------------------------------------------------------
+// Function: ReadFormatRows
+// Convert mapped 16 bit, half float or 10 bit pixels to 8 bit RGBA or RGB
+//   Different dimensions are re-sampled in the same pass,
+//   divided into bands of destination rows.
+//   Same size conversions are divided into bands of changed rows.
+void spoutDX::ReadFormatRows(const void* source, unsigned int pitch, unsigned char* destpixels,
+	unsigned int width, unsigned int height, bool bRGB, bool bInvert, bool bSwap)
+{
+	const unsigned char* src = static_cast<const unsigned char*>(source);
+	const unsigned int destpitch = width*(bRGB ? 3 : 4);
+
+	// Swap for RGB/BGR pixels as for an RGBA texture
+	const bool bSwapRGB = bRGB ? !bSwap : bSwap;
+	const bool bMirror = bRGB && m_bMirror;
+
+	if (width != m_ReadWidth || height != m_ReadHeight) {
+		ConvertRows(height, [&](unsigned int y0, unsigned int y1) {
+			spoutcopy.format2rgba(src, destpixels, m_dwFormat, m_ReadWidth, m_ReadHeight, pitch,
+				width, height, destpitch, y0, y1, bRGB, bInvert, bMirror, bSwapRGB);
+		});
+		return;
+	}
+
+	// Source rows y0 - y1. The destination rows are reversed if inverted.
+	const DWORD conversion = GetToneCode() | (m_dwFormat << 8) | (bRGB ? 1 : 0)
+		| (bInvert ? 2 : 0) | (bMirror ? 4 : 0) | (bSwap ? 8 : 0);
+	ConvertChangedRows(src, pitch, destpixels, conversion, false, [&](unsigned int y0, unsigned int y1) {
+		const unsigned int dy = bInvert ? (m_ReadHeight - y1) : y0;
+		spoutcopy.format2rgba(src + (size_t)y0*pitch, destpixels + (size_t)dy*destpitch, m_dwFormat,
+			width, y1 - y0, pitch, width, y1 - y0, destpitch, bRGB, bInvert, bMirror, bSwapRGB);
+	});
+}
+
+//---------------------------------------------------------
+// Function: ReadRotatedRows
+// Rotate mapped pixels of any staging format to 8 bit RGBA or RGB
+//   The receiving size is the rotated staging texture size,
+//   or it is re-sampled to the nearest pixel. Fit modes are not used.
+//   Rows are divided into bands. Change detection compares source rows
+//   and is not used because they are columns of the rotated frame.
+void spoutDX::ReadRotatedRows(const void* source, unsigned int pitch, unsigned char* destpixels,
+	unsigned int width, unsigned int height, bool bRGB, bool bInvert, bool bSwap)
+{
+	const unsigned int destpitch = width*(bRGB ? 3 : 4);
+
+	// Swap for RGB/BGR pixels as for ReadFormatRows if the texture is RGBA
+	const bool bRGBA = (m_dwFormat == 28 || spoutcopy.FormatBytes(m_dwFormat) > 0);
+	const bool bSwapRGB = (bRGB && bRGBA) ? !bSwap : bSwap;
+	const bool bMirror = bRGB && m_bMirror;
+
+	m_pChangeDest = nullptr;
+	ConvertRows(height, [&](unsigned int y0, unsigned int y1) {
+		spoutcopy.rotate2rgba(source, destpixels, m_dwFormat, m_ReadWidth, m_ReadHeight, pitch,
+			width, height, destpitch, m_Rotation, y0, y1, bRGB, bInvert, bMirror, bSwapRGB);
+	});
+}
+
+//---------------------------------------------------------
+// Function: GetToneCode
+// Tone mapping mode and exposure for conversion codes
+//   Bits 16-17 mode and 18-31 exposure x 100.
+//   Zero unless a half float staging texture is tone mapped.
+DWORD spoutDX::GetToneCode()
+{
+	const int mode = spoutcopy.GetToneMapping();
+	const float exposure = spoutcopy.GetExposure();
+	if (m_dwFormat != 10 || (mode == SPOUT_TONEMAP_NONE && exposure == 1.0f))
+		return 0;
+	DWORD percent = (DWORD)(exposure*100.0f + 0.5f);
+	if (percent > 0x3FFF) percent = 0x3FFF;
+	return ((DWORD)mode << 16) | (percent << 18);
+}
+
+//---------------------------------------------------------
+// Function: UpdateColourAdjust
+// Apply colour adjustment in the byte order of the staging texture
+//   Tables and matrix are set in RGB order and re-ordered
+//   for BGRA textures, so the conversion functions adjust
+//   source bytes before any swap of red and blue.
+void spoutDX::UpdateColourAdjust()
+{
+	const int order = (m_dwFormat == 28 || spoutcopy.FormatBytes(m_dwFormat) > 0) ? 0 : 1;
+	if (order == m_ColourOrder)
+		return;
+	m_ColourOrder = order;
+
+	if (!m_bColourAdjust) {
+		spoutcopy.ClearColourAdjust();
+		return;
+	}
+
+	// RGB channel of each source byte
+	unsigned int channel[3] = { 0, 1, 2 };
+	if (order == 1) {
+		channel[0] = 2;
+		channel[2] = 0;
+	}
+	float matrix[9]{};
+	for (unsigned int row = 0; row < 3; row++) {
+		for (unsigned int col = 0; col < 3; col++)
+			matrix[row*3 + col] = m_ColourMatrix[channel[row]*3 + channel[col]];
+	}
+	spoutcopy.SetColourAdjust(m_ColourTable[channel[0]], m_ColourTable[channel[1]],
+		m_ColourTable[channel[2]], m_bColourMatrix ? matrix : nullptr);
+}
+
+//---------------------------------------------------------
+// Function: GetSenderRegion
+// Region of the sender to receive, limited to the sender size
+//   Returns false for the whole sender.
+bool spoutDX::GetSenderRegion(D3D11_BOX &box)
+{
+	box.left = 0;
+	box.top = 0;
+	box.front = 0;
+	box.right = m_Width;
+	box.bottom = m_Height;
+	box.back = 1;
+
+	if (m_Region[2] == 0 || m_Region[3] == 0 || m_Region[0] >= m_Width || m_Region[1] >= m_Height)
+		return false;
+
+	box.left = m_Region[0];
+	box.top = m_Region[1];
+	box.right = (m_Region[2] < m_Width - m_Region[0]) ? (m_Region[0] + m_Region[2]) : m_Width;
+	box.bottom = (m_Region[3] < m_Height - m_Region[1]) ? (m_Region[1] + m_Region[3]) : m_Height;
+
+	return (box.left > 0 || box.top > 0 || box.right < m_Width || box.bottom < m_Height);
+}
+
+//---------------------------------------------------------
+// Function: UpdateFit
+// Sender and receiving regions for the fit mode
+//   Calculated only when the sender or receiving size or the mode changes.
+//   Letterbox scales the whole sender into the largest centred region
+//   of the same aspect ratio. Crop scales the centre of the sender
+//   with the aspect ratio of the receiving size to fill it.
+void spoutDX::UpdateFit(unsigned int width, unsigned int height)
+{
+	const unsigned int key[5] = { m_ReadWidth, m_ReadHeight, width, height, (unsigned int)m_FitMode };
+	if (memcmp(key, m_FitKey, sizeof(key)) == 0)
+		return;
+	memcpy(m_FitKey, key, sizeof(key));
+
+	// Whole sender to the whole receiving size
+	unsigned int src[4] = { 0, 0, m_ReadWidth, m_ReadHeight };
+	unsigned int dst[4] = { 0, 0, width, height };
+
+	// Compare aspect ratios without division
+	const uint64_t sendershape = (uint64_t)m_ReadWidth*height;
+	const uint64_t receivershape = (uint64_t)width*m_ReadHeight;
+
+	if (m_FitMode == SPOUT_FIT_LETTERBOX) {
+		if (receivershape > sendershape) {
+			// Receiver is wider - borders left and right
+			dst[2] = (unsigned int)(sendershape/m_ReadHeight);
+			dst[0] = (width - dst[2])/2;
+		}
+		else if (receivershape < sendershape) {
+			// Receiver is taller - borders top and bottom
+			dst[3] = (unsigned int)(receivershape/m_ReadWidth);
+			dst[1] = (height - dst[3])/2;
+		}
+	}
+	else if (m_FitMode == SPOUT_FIT_CROP) {
+		if (receivershape > sendershape) {
+			// Receiver is wider - crop top and bottom of the sender
+			src[3] = (unsigned int)(sendershape/width);
+			src[1] = (m_ReadHeight - src[3])/2;
+		}
+		else if (receivershape < sendershape) {
+			// Receiver is taller - crop left and right of the sender
+			src[2] = (unsigned int)(receivershape/height);
+			src[0] = (m_ReadWidth - src[2])/2;
+		}
+	}
+
+	// At least one pixel
+	if (src[2] == 0) src[2] = 1;
+	if (src[3] == 0) src[3] = 1;
+	if (dst[2] == 0) dst[2] = 1;
+	if (dst[3] == 0) dst[3] = 1;
+
+	memcpy(m_FitSource, src, sizeof(src));
+	memcpy(m_FitDest, dst, sizeof(dst));
+
+	// Borders are filled again
+	m_BorderBuffers.clear();
+
+	SpoutLogNotice("spoutDX::UpdateFit - sender %d, %d, %d, %d to %d, %d, %d, %d",
+		src[0], src[1], src[2], src[3], dst[0], dst[1], dst[2], dst[3]);
+}
+
+//---------------------------------------------------------
+// Function: ResampleFit
+// Re-sample mapped pixels to a region of the receiving size
+//   Only the region is converted, in bands of region rows.
+//   The borders are filled once for each pixel buffer and not
+//   again unless the size, format or border colour change.
+void spoutDX::ResampleFit(const void* source, unsigned int pitch, unsigned char* destpixels,
+	unsigned int width, unsigned int height, bool bRGB, bool bInvert, bool bSwap)
+{
+	UpdateFit(width, height);
+
+	const unsigned int bpp = bRGB ? 3 : 4;
+	const unsigned int destpitch = width*bpp;
+
+	// 16 bit, half float and 10 bit textures are converted as RGBA (see ReadFormatRows)
+	const unsigned int formatbytes = spoutcopy.FormatBytes(m_dwFormat);
+	const bool bRGBA = (m_dwFormat == 28 || formatbytes > 0);
+
+	// Swap for RGB/BGR pixels (see ReadPixelData)
+	// RGBA pixels are swapped only for high bit depth formats
+	const bool bSwapRGB = bRGBA ? !bSwap : bSwap;
+	const bool bSwapPixels = bRGB ? bSwapRGB : (formatbytes > 0 && bSwap);
+	const bool bMirror = bRGB && m_bMirror;
+
+	// Region position allowing for flip and mirror
+	// The position is reversed if the borders are not equal.
+	const unsigned int dx = bMirror ? (width - m_FitDest[0] - m_FitDest[2]) : m_FitDest[0];
+	const unsigned int dy = bInvert ? (height - m_FitDest[1] - m_FitDest[3]) : m_FitDest[1];
+
+	// Border pixel in the byte order of the conversion
+	// RGBA texture - DXGI_FORMAT_R8G8B8A8_UNORM (28) or high bit depth, otherwise BGRA
+	const unsigned char red   = (unsigned char)((m_BorderColour >> 16) & 0xFF);
+	const unsigned char green = (unsigned char)((m_BorderColour >> 8) & 0xFF);
+	const unsigned char blue  = (unsigned char)(m_BorderColour & 0xFF);
+	unsigned char texel[4] = { blue, green, red, 255 };
+	if (bRGBA) {
+		texel[0] = red;
+		texel[2] = blue;
+	}
+	unsigned char pixel[4] = { texel[0], texel[1], texel[2], texel[3] };
+	if (bSwapPixels) {
+		pixel[0] = texel[2];
+		pixel[2] = texel[0];
+	}
+
+	// Borders for each pixel buffer
+	if (m_FitDest[2] < width || m_FitDest[3] < height) {
+		uint64_t key = 0;
+		memcpy(&key, pixel, 4);
+		key |= ((uint64_t)bpp << 32) | ((uint64_t)(bInvert ? 1 : 0) << 40) | ((uint64_t)(bMirror ? 1 : 0) << 41);
+		if (key != m_BorderKey) {
+			m_BorderKey = key;
+			m_BorderBuffers.clear();
+		}
+		if (std::find(m_BorderBuffers.begin(), m_BorderBuffers.end(), destpixels) == m_BorderBuffers.end()) {
+			FillBorders(destpixels, width, height, dx, dy, bpp, pixel);
+			// Allocators usually have few buffers
+			if (m_BorderBuffers.size() >= 8)
+				m_BorderBuffers.clear();
+			m_BorderBuffers.push_back(destpixels);
+		}
+	}
+
+	// Sender region to the receiving region
+	const unsigned char* src = static_cast<const unsigned char*>(source)
+		+ (size_t)m_FitSource[1]*pitch + (size_t)m_FitSource[0]*(formatbytes ? formatbytes : 4);
+	unsigned char* dst = destpixels + (size_t)dy*destpitch + (size_t)dx*bpp;
+	ConvertRows(m_FitDest[3], [&](unsigned int y0, unsigned int y1) {
+		if (formatbytes > 0) {
+			spoutcopy.format2rgba(src, dst, m_dwFormat, m_FitSource[2], m_FitSource[3], pitch,
+				m_FitDest[2], m_FitDest[3], destpitch, y0, y1, bRGB, bInvert, bMirror, bSwapPixels);
+		}
+		else if (!bRGB) {
+			spoutcopy.rgba2rgbaResample(src, dst, m_FitSource[2], m_FitSource[3], pitch,
+				m_FitDest[2], m_FitDest[3], destpitch, y0, y1, bInvert);
+		}
+		else {
+			spoutcopy.rgba2rgbResample(src, dst, m_FitSource[2], m_FitSource[3], pitch,
+				m_FitDest[2], m_FitDest[3], destpitch, y0, y1, bInvert, m_bMirror, bSwapRGB);
+		}
+	});
+}
+
+//---------------------------------------------------------
+// Function: FillBorders
+// Fill the borders outside the receiving region
+//   Rows above and below the region are filled in one pass.
+void spoutDX::FillBorders(unsigned char* destpixels, unsigned int width, unsigned int height,
+	unsigned int dx, unsigned int dy, unsigned int bpp, const unsigned char* pixel)
+{
+	const size_t destpitch = (size_t)width*bpp;
+	const unsigned int dw = m_FitDest[2];
+	const unsigned int dh = m_FitDest[3];
+
+	// Above and below
+	if (dy > 0)
+		spoutcopy.FillPixels(destpixels, (size_t)width*dy, bpp, pixel);
+	if (dy + dh < height)
+		spoutcopy.FillPixels(destpixels + (dy + dh)*destpitch, (size_t)width*(height - dy - dh), bpp, pixel);
+
+	// Left and right
+	if (dw < width) {
+		for (unsigned int y = dy; y < dy + dh; y++) {
+			unsigned char* row = destpixels + y*destpitch;
+			if (dx > 0)
+				spoutcopy.FillPixels(row, dx, bpp, pixel);
+			if (dx + dw < width)
+				spoutcopy.FillPixels(row + (size_t)(dx + dw)*bpp, width - dx - dw, bpp, pixel);
+		}
+	}
+}
+
+//---------------------------------------------------------
+// Function: ReadPixelRows
+// Copy mapped RGBA/BGRA pixels of the class size to RGB/BGR
+//   Source rows y0 - y1. The destination rows are reversed if inverted.
+void spoutDX::ReadPixelRows(const void* source, unsigned char* destpixels,
+	unsigned int pitch, bool bInvert, bool bSwap)
+{
+	const unsigned char* src = static_cast<const unsigned char*>(source);
+	const DWORD conversion = (m_dwFormat << 8) | 1
+		| (bInvert ? 2 : 0) | (m_bMirror ? 4 : 0) | (bSwap ? 8 : 0);
+	ConvertChangedRows(src, pitch, destpixels, conversion, false, [&](unsigned int y0, unsigned int y1) {
+		const unsigned int dy = bInvert ? (m_ReadHeight - y1) : y0;
+		spoutcopy.rgba2rgb(src + (size_t)y0*pitch, destpixels + (size_t)dy*m_ReadWidth*3,
+			m_ReadWidth, y1 - y0, pitch, bInvert, m_bMirror, bSwap);
+	});
+}
+
+//---------------------------------------------------------
+// Function: ConvertChangedRows
+// Convert the bands of source rows that have changed since the last frame
+//   Each band of SPOUT_CHANGE_ROWS source rows is hashed and compared
+//   with the last frame. The destination holds the last conversion
+//   if it is the same buffer and the conversion has not changed.
+//   Function rows are reversed from source rows if bReverse is set.
+void spoutDX::ConvertChangedRows(const unsigned char* source, unsigned int pitch,
+	const unsigned char* destpixels, DWORD conversion, bool bReverse,
+	const std::function<void(unsigned int, unsigned int)>& func)
+{
+	if (!m_bChangeDetect) {
+		ConvertRows(m_ReadHeight, func);
+		return;
+	}
+
+	SPOUT_TIMING("spoutDX::ConvertChangedRows");
+
+	const unsigned int rows = m_ReadHeight;
+	const unsigned int bands = (rows + SPOUT_CHANGE_ROWS - 1)/SPOUT_CHANGE_ROWS;
+	const unsigned int formatbytes = spoutcopy.FormatBytes(m_dwFormat);
+	const unsigned int rowbytes = m_ReadWidth*(formatbytes ? formatbytes : 4);
+
+	const bool bValid = (destpixels == m_pChangeDest && conversion == m_ChangeConversion
+		&& m_ReadWidth == m_ChangeWidth && bands == (unsigned int)m_BandHash.size());
+	if (bands != (unsigned int)m_BandHash.size())
+		m_BandHash.resize(bands);
+
+	// Hash each band and record the bands that have changed
+	m_ChangedBands.clear();
+	for (unsigned int b = 0; b < bands; b++) {
+		const unsigned int y0 = b*SPOUT_CHANGE_ROWS;
+		const unsigned int y1 = (y0 + SPOUT_CHANGE_ROWS < rows) ? (y0 + SPOUT_CHANGE_ROWS) : rows;
+		const uint64_t hash = spoutcopy.HashRows(source + (size_t)y0*pitch, rowbytes, y1 - y0, pitch);
+		if (!bValid || hash != m_BandHash[b]) {
+			m_BandHash[b] = hash;
+			m_ChangedBands.push_back(b);
+		}
+	}
+
+	const unsigned int changed = (unsigned int)m_ChangedBands.size();
+	m_ChangeFrames++;
+	m_ConvertedBands += changed;
+	m_SkippedBands += (bands - changed);
+
+	if (changed == bands) {
+		// All rows, divided by the row scheduler
+		ConvertRows(rows, func);
+	}
+	else if (changed == 0) {
+		// Identical frame
+		m_SkippedFrames++;
+	}
+	else {
+		// Runs of adjacent changed bands
+		unsigned int i = 0;
+		while (i < changed) {
+			unsigned int j = i + 1;
+			while (j < changed && m_ChangedBands[j] == m_ChangedBands[j-1] + 1)
+				j++;
+			const unsigned int y0 = m_ChangedBands[i]*SPOUT_CHANGE_ROWS;
+			unsigned int y1 = (m_ChangedBands[j-1] + 1)*SPOUT_CHANGE_ROWS;
+			if (y1 > rows) y1 = rows;
+			if (bReverse)
+				func(rows - y1, rows - y0);
+			else
+				func(y0, y1);
+			i = j;
+		}
+	}
+
+	m_pChangeDest = destpixels;
+	m_ChangeConversion = conversion;
+	m_ChangeWidth = m_ReadWidth;
+}
+
+//---------------------------------------------------------
+// Function: ConvertRows
+// Convert all rows, divided into bands if a row scheduler is set
+void spoutDX::ConvertRows(unsigned int rows, const std::function<void(unsigned int, unsigned int)>& func)
+{
+	if (m_pRowScheduler)
+		m_pRowScheduler->Run(rows, func);
+	else
+		func(0, rows);
+}
+
 
 // Create new class staging textures if changed size or do not exist yet
 bool spoutDX::CheckStagingTextures(unsigned int width, unsigned int height, DWORD dwFormat)
@@ -53,6 +53,7 @@
 #include "SpoutDirectX.h"
 #include "SpoutCopy.h"
 #include "SpoutUtils.h"
+#include "SpoutTimecode.h"
 #else
 #include "..\SpoutSDK\SpoutCommon.h"
 #include "..\SpoutSDK\SpoutSenderNames.h"
@@ -60,16 +61,64 @@
 #include "..\SpoutSDK\SpoutDirectX.h"
 #include "..\SpoutSDK\SpoutCopy.h"
 #include "..\SpoutSDK\SpoutUtils.h"
+#include "..\SpoutSDK\SpoutTimecode.h"
 #endif
 
 #include <direct.h>      // for _getcwd
 #include <TlHelp32.h>    // for PROCESSENTRY32
 #include <tchar.h>       // for _tcsicmp
 #include <psapi.h>       // for GetModuleFileNameExA
+#include <functional>    // for row band conversion
+#include <vector>        // for change detection
+#include <algorithm>     // for std::find
+#include <math.h>        // for powf
 
 #pragma comment(lib, "Psapi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 
+// Rows in each band for change detection (see SetChangeDetection)
+#define SPOUT_CHANGE_ROWS 16
+
+// Fit of the sender to a different receiving size (see SetFitMode)
+#define SPOUT_FIT_STRETCH   0 // Fill the receiving size
+#define SPOUT_FIT_LETTERBOX 1 // Whole sender with borders
+#define SPOUT_FIT_CROP      2 // Fill the receiving size and crop the sender
+
+//
+// Row scheduler for pixel conversion
+//
+// ReadPixelData divides conversions and re-sampling into bands of rows
+// if a scheduler is set (SetRowScheduler). Run must call the function
+// for bands that together cover all rows, from any thread, and return
+// when all bands are complete.
+//
+class SpoutRowScheduler {
+	public:
+	virtual ~SpoutRowScheduler() {}
+	virtual void Run(unsigned int rows, const std::function<void(unsigned int, unsigned int)>& func) = 0;
+};
+
+//
+// Cache of converted frames
+//
+// If a cache is set (SetFrameCache), ReceiveImage looks for the pixels
+// of a sender frame before reading them from the staging texture and
+// saves them after conversion. A cache shared by receivers in other
+// processes allows each sender frame to be converted once for each
+// destination size and conversion. The conversion code identifies
+// the pixel format and options (see ReceiveImage).
+//
+class SpoutFrameCache {
+	public:
+	virtual ~SpoutFrameCache() {}
+	// Copy the pixels of a frame if they are available
+	virtual bool Read(const char* sendername, uint64_t frame, DWORD conversion,
+		unsigned int width, unsigned int height, unsigned char* pixels, unsigned int size) = 0;
+	// Save the pixels of a converted frame
+	virtual void Write(const char* sendername, uint64_t frame, DWORD conversion,
+		unsigned int width, unsigned int height, const unsigned char* pixels, unsigned int size) = 0;
+};
+
 class SPOUT_DLLEXP spoutDX {
 
 	public:
@@ -160,6 +209,18 @@ class SPOUT_DLLEXP spoutDX {
 	double GetSenderFps();
 	// Received sender frame number
 	long GetSenderFrame();
+	// Received sender capture to receive latency (msec)
+	double GetSenderLatency();
+	// Received sender frame interval jitter (msec)
+	double GetSenderFrameJitter();
+	// Received sender minimum frame interval (msec)
+	double GetSenderFrameIntervalMin();
+	// Received sender maximum frame interval (msec)
+	double GetSenderFrameIntervalMax();
+	// Received sender frame bursts
+	long GetSenderBurstCount();
+	// Wait for a new sender frame or timeout (msec)
+	bool WaitNewFrame(DWORD dwTimeout);
 	
 	//
 	// COMMON
@@ -167,6 +228,8 @@ class SPOUT_DLLEXP spoutDX {
 
 	// Frame rate control
 	void HoldFps(int fps);
+	// Nominal sender frame rate for receivers, zero if unknown
+	void SetNominalFps(double fps);
 	// Disable frame counting for this application
 	void DisableFrameCount();
 	// Return frame count status
@@ -310,6 +373,42 @@ class SPOUT_DLLEXP spoutDX {
 	void SetSwap(bool bSwap = true); // RGB <> BGR
 	bool GetMirror();
 	bool GetSwap();
+	// Scheduler for pixel conversion (nullptr for the calling thread)
+	void SetRowScheduler(SpoutRowScheduler* pScheduler);
+	// Cache of converted frames (nullptr for none)
+	void SetFrameCache(SpoutFrameCache* pCache);
+	// Convert only rows that have changed since the last frame
+	void SetChangeDetection(bool bDetect = true);
+	bool GetChangeDetection();
+	// Frames checked and conversion avoided
+	void GetChangeCounts(long long &frames, long long &skippedframes,
+		long long &convertedbands, long long &skippedbands);
+	// Fit of the sender to a different receiving size
+	void SetFitMode(int mode = SPOUT_FIT_LETTERBOX);
+	int GetFitMode();
+	// Letterbox border colour (0xRRGGBB)
+	void SetBorderColour(DWORD colour);
+	DWORD GetBorderColour();
+	// Region of the sender to receive (zero width or height for all)
+	void SetSourceRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+	void GetSourceRegion(unsigned int &x, unsigned int &y, unsigned int &width, unsigned int &height);
+	// Tone mapping of half float senders with exposure
+	void SetToneMapping(int mode = SPOUT_TONEMAP_REINHARD, float exposure = 1.0f);
+	int GetToneMapping();
+	float GetExposure();
+	// Colour adjustment of received pixels
+	void SetColourAdjust(float brightness = 0.0f, float contrast = 1.0f, float gamma = 1.0f,
+		float saturation = 1.0f, unsigned int black = 0, unsigned int white = 255);
+	void SetColourTables(const unsigned char* red, const unsigned char* green,
+		const unsigned char* blue, const float* matrix = nullptr);
+	void ClearColourAdjust();
+	bool GetColourAdjust();
+	// Clockwise rotation of received pixels (0, 90, 180 or 270 degrees)
+	void SetRotation(unsigned int degrees);
+	unsigned int GetRotation();
+	// Timecode watermark of the sender frame number and capture time
+	void SetTimecode(bool bTimecode, unsigned int cell = SPOUT_TIMECODE_CELL);
+	bool GetTimecode();
 
 	//
 	// Public for external access
@@ -351,14 +450,57 @@ protected :
 	bool m_bMemoryShare = false; // Using 2.006 memoryshare methods
 	bool m_bMirror = false; // Mirror image
 	bool m_bSwapRB = false; // RGB <> BGR
+	SpoutRowScheduler* m_pRowScheduler = nullptr; // Pixel conversion scheduler
+	SpoutFrameCache* m_pFrameCache = nullptr; // Converted frame cache
+	uint64_t m_StagingFrame[2] = {}; // Sender frame number of each staging texture
+
+	// Change detection
+	bool m_bChangeDetect = false;
+	std::vector<uint64_t> m_BandHash; // Hash of each band of the last frame
+	std::vector<unsigned int> m_ChangedBands; // Bands changed in this frame
+	const unsigned char* m_pChangeDest = nullptr; // Buffer holding the last conversion
+	DWORD m_ChangeConversion = 0; // Conversion code of the last frame
+	unsigned int m_ChangeWidth = 0;
+	long long m_ChangeFrames = 0;
+	long long m_SkippedFrames = 0;
+	long long m_ConvertedBands = 0;
+	long long m_SkippedBands = 0;
+
+	// Fit mode
+	int m_FitMode = SPOUT_FIT_STRETCH;
+	DWORD m_BorderColour = 0;
+	unsigned int m_FitKey[5] = {}; // Sender and receiving size and mode of the fit
+	unsigned int m_FitSource[4] = {}; // Sender region x, y, width, height
+	unsigned int m_FitDest[4] = {}; // Receiving region x, y, width, height
+	uint64_t m_BorderKey = 0; // Border pixel and position of filled buffers
+	std::vector<const unsigned char*> m_BorderBuffers; // Buffers with borders filled
+
+	// Source region
+	unsigned int m_Region[4] = {}; // Sender region x, y, width, height
+	unsigned int m_ReadWidth = 0; // Size of the staging texture read by ReadPixelData
+	unsigned int m_ReadHeight = 0;
+
+	// Colour adjustment
+	bool m_bColourAdjust = false;
+	unsigned char m_ColourTable[3][256] = {}; // Red, green and blue tables
+	float m_ColourMatrix[9] = {}; // RGB matrix by rows
+	bool m_bColourMatrix = false;
+	int m_ColourOrder = -1; // Byte order applied to spoutcopy, -1 if changed
+
+	// Rotation
+	unsigned int m_Rotation = 0; // Degrees clockwise
+
+	// Timecode watermark
+	bool m_bTimecode = false;
+	unsigned int m_TimecodeCell = SPOUT_TIMECODE_CELL; // Cell size in pixels
+	uint64_t m_TimecodeFrame[2] = {}; // Frame number of each staging texture
+	uint64_t m_TimecodeTime[2] = {}; // Capture time of each staging texture (microseconds)
+
 	SHELLEXECUTEINFOA m_ShExecInfo{}; // For ShellExecute
 
 	// For WriteMemoryBuffer/ReadMemoryBuffer
 	SpoutSharedMemory memorybuffer;
 	bool bCopyRgb = true; // Copy to R8 byte texture for SpoutCam
-	double timingAvg = 0.0;
-	double timingSum = 0.0;
-	double timingNum = 0.0;
 	// Initialize or update the sender
 	bool CheckSender(unsigned int width, unsigned int height, DWORD dwFormat);
 
@@ -370,6 +512,35 @@ protected :
 
 	void CreateReceiver(const char * sendername, unsigned int width, unsigned int height, DWORD dwFormat);
 	
+	// Convert all rows, divided into bands if a row scheduler is set
+	void ConvertRows(unsigned int rows, const std::function<void(unsigned int, unsigned int)>& func);
+	// Convert rows that have changed since the last frame
+	void ConvertChangedRows(const unsigned char* source, unsigned int pitch,
+		const unsigned char* destpixels, DWORD conversion, bool bReverse,
+		const std::function<void(unsigned int, unsigned int)>& func);
+	// Region of the sender to receive
+	bool GetSenderRegion(D3D11_BOX &box);
+	// Sender and receiving regions for the fit mode
+	void UpdateFit(unsigned int width, unsigned int height);
+	// Re-sample mapped pixels to a region of the receiving size
+	void ResampleFit(const void* source, unsigned int pitch, unsigned char* destpixels,
+		unsigned int width, unsigned int height, bool bRGB, bool bInvert, bool bSwap);
+	// Fill the borders outside the receiving region
+	void FillBorders(unsigned char* destpixels, unsigned int width, unsigned int height,
+		unsigned int dx, unsigned int dy, unsigned int bpp, const unsigned char* pixel);
+	// Copy mapped pixels of the class size to RGB/BGR by row bands
+	void ReadPixelRows(const void* source, unsigned char* destpixels, unsigned int pitch, bool bInvert, bool bSwap);
+	// Convert mapped 16 bit, half float or 10 bit pixels to RGBA or RGB
+	void ReadFormatRows(const void* source, unsigned int pitch, unsigned char* destpixels,
+		unsigned int width, unsigned int height, bool bRGB, bool bInvert, bool bSwap);
+	// Rotate mapped pixels to RGBA or RGB by row bands
+	void ReadRotatedRows(const void* source, unsigned int pitch, unsigned char* destpixels,
+		unsigned int width, unsigned int height, bool bRGB, bool bInvert, bool bSwap);
+	// Tone mapping mode and exposure for conversion codes
+	DWORD GetToneCode();
+	// Apply colour adjustment in the byte order of the staging texture
+	void UpdateColourAdjust();
+
 	// Read pixels from a staging texture
 	bool ReadPixelData(ID3D11Texture2D* pStagingSource, unsigned char* destpixels,
 		unsigned int width, unsigned int height, bool bRGB, bool bInvert, bool bSwap);
@@ -89,6 +89,40 @@
 //		31.12.23	- Add comments to clarify the purpose of "EnableFrameSync"
 //	Version 2.007.014
 //		04.07.24	- SetNewFrame - add m_hCountSemaphore to initial check
+//		19.10.26	- Add extended sender frame information map (SharedTextureInfoEx)
+//					  with frame counter, capture time stamp and nominal fps.
+//					  SetNewFrame - update the map. GetNewFrame - use the map frame
+//					  counter if written by the sender, otherwise the semaphore.
+//					  Add GetSenderLatency and GetSenderFrameInfo
+//					- Add new frame event "<sendername>_NewFrame_Event" signalled
+//					  by SetNewFrame and WaitNewFrame for a receiver to wait
+//					  for a new frame or timeout instead of polling
+//					- Frame information version 3. Update the 64 bit frame counter
+//					  with interlocked operations and read it without locking the map.
+//					  Receivers use the counter if the sender supports it, otherwise
+//					  the semaphore, which the sender still updates for earlier receivers.
+//					- UpdateSenderFps - replace fixed average and damping with a
+//					  trimmed mean of frame intervals over a one second window.
+//					  Add GetSenderFrameJitter, GetSenderFrameIntervalMin/Max
+//					  and GetSenderBurstCount
+//		19.10.26	- HoldFps - absolute frame deadlines carried forward each frame,
+//					  waitable timer sleep and spin for the last 500 microseconds.
+//					  Timer period held for the session instead of every frame.
+//					  HoldFps(0) or CleanupFrameCount ends the session.
+//		19.10.26	- New frame events "<sendername>_NewFrame_Event_0" and "_1"
+//					  for even and odd frame counts, manual reset, instead of one
+//					  auto-reset event which released only one of several receivers.
+//		19.10.26	- HoldFps - deadline, sleep and spin timing moved to SpoutFramePacer.h
+//					  with the clock and sleep functions supplied by HoldFps.
+//		19.10.26	- ReadFrameInfo - return false for a frame information version
+//					  before 3 instead of locking the map, so that receivers of
+//					  earlier senders use the semaphore without extra kernel calls.
+//		19.10.26	- AddFrameInterval - partition the interval window with
+//					  std::nth_element for the trimmed mean and median instead
+//					  of sorting it for every frame.
+//		19.10.26	- Add SetNominalFps. WriteFrameInfo - write the nominal
+//					  frame rate set by the sender or HoldFps, or zero if unknown,
+//					  instead of the estimated sender fps.
 //
 // ====================================================================================
 //
@@ -118,6 +152,19 @@
 
 #include "SpoutFrameCount.h"
 
+// Atomic read of a 64 bit value in shared memory.
+// Aligned 64 bit reads are atomic for x64.
+// Otherwise use an interlocked operation.
+static inline uint64_t ReadAtomic64(const volatile uint64_t* p)
+{
+#if defined(_M_X64)
+	return *p;
+#else
+	return static_cast<uint64_t>(InterlockedCompareExchange64(
+		reinterpret_cast<volatile LONG64*>(const_cast<volatile uint64_t*>(p)), 0, 0));
+#endif
+}
+
 //
 // Class: spoutFrameCount
 //
@@ -132,6 +179,8 @@ spoutFrameCount::spoutFrameCount()
 	m_hAccessMutex = NULL;
 	m_hCountSemaphore = NULL;
 	m_hSyncEvent = NULL;
+	m_hNewFrameEvent[0] = NULL;
+	m_hNewFrameEvent[1] = NULL;
 	m_SenderName[0] = 0;
 	m_CountSemaphoreName[0] = 0;
 	
@@ -143,9 +192,23 @@ spoutFrameCount::spoutFrameCount()
 	m_lastFrame = 0.0;
 	m_SystemFps = GetRefreshRate(); // System refresh rate
 	m_SenderFps = m_SystemFps; // Default sender fps is system refresh rate
+	m_NominalFps = 0.0; // Nominal sender fps is unknown
 	m_PeriodMin = 0; // For setting Windows time period
+	m_HoldFps = 0; // For HoldFps
+	m_HoldDeadline = 0.0;
+	m_hHoldTimer = NULL;
 	m_bIsNewFrame = true; // Default true for apps without frame count
 
+	// Extended sender frame information
+	m_bFrameInfo = false;
+	m_FrameInfoLast = {};
+	m_LastFrameInfoCount = 0;
+	m_SenderLatency = 0.0;
+	m_bAtomicCount = false;
+
+	// Sender frame interval statistics
+	ResetFrameIntervals();
+
 	// Check the registry setting for frame counting between sender and receiver
 	m_bFrameCount = false; // default not set
 	DWORD dwFrame = 0;
@@ -201,6 +264,8 @@ spoutFrameCount::~spoutFrameCount()
 	if (m_hCountSemaphore) CloseHandle(m_hCountSemaphore);
 	if (m_hAccessMutex) CloseHandle(m_hAccessMutex);
 	if (m_hSyncEvent) CloseHandle(m_hSyncEvent);
+	CloseNewFrameEvent();
+	EndHoldFps();
 
 }
 
@@ -276,6 +341,9 @@ void spoutFrameCount::EnableFrameCount(const char* SenderName)
 	m_FrameTimeTotal = 0.0;
 	m_FrameTimeNumber = 0.0;
 	m_SenderFps = m_SystemFps; // Default sender fps is system refresh rate
+	m_LastFrameInfoCount = 0;
+	m_SenderLatency = 0.0;
+	ResetFrameIntervals();
 
 	// Reset timers
 #ifdef USE_CHRONO
@@ -287,6 +355,11 @@ void spoutFrameCount::EnableFrameCount(const char* SenderName)
 	StartCounter();
 #endif
 
+	// Create or open the extended sender frame information map
+	// and the new frame event
+	OpenFrameInfo(SenderName);
+	OpenNewFrameEvent(SenderName);
+
 	// Return if already enabled for this sender
 	// The sender name can be the same if the adapter has changed
 	if (m_hCountSemaphore) {
@@ -404,6 +477,167 @@ long spoutFrameCount::GetSenderFrame()
 	return m_FrameCount;
 }
 
+// -----------------------------------------------
+// Function: GetSenderLatency
+// Sender to receiver latency of the last new frame (msec)
+//
+// Time from the sender capture time stamp to the frame received.
+// Zero if the sender does not write extended frame information.
+double spoutFrameCount::GetSenderLatency()
+{
+	return m_SenderLatency;
+}
+
+// -----------------------------------------------
+// Function: GetSenderFrameJitter
+// Sender frame interval jitter (msec)
+//
+// Standard deviation of the frame intervals over the last second.
+// Zero until sufficient frames have been received.
+double spoutFrameCount::GetSenderFrameJitter()
+{
+	return m_FrameJitter;
+}
+
+// -----------------------------------------------
+// Function: GetSenderFrameIntervalMin
+// Minimum sender frame interval over the last second (msec)
+double spoutFrameCount::GetSenderFrameIntervalMin()
+{
+	return m_FrameIntervalMin;
+}
+
+// -----------------------------------------------
+// Function: GetSenderFrameIntervalMax
+// Maximum sender frame interval over the last second (msec)
+double spoutFrameCount::GetSenderFrameIntervalMax()
+{
+	return m_FrameIntervalMax;
+}
+
+// -----------------------------------------------
+// Function: GetSenderBurstCount
+// Number of sender frame bursts
+//
+// Frames that arrived in less than half the typical frame
+// interval since the sender was connected. A high count
+// indicates a sender with uneven frame timing.
+long spoutFrameCount::GetSenderBurstCount()
+{
+	return m_FrameBurstCount;
+}
+
+// -----------------------------------------------
+// Function: GetSenderFrameInfo
+// Extended sender frame information last received
+//
+// Returns false if the sender has not written the information.
+bool spoutFrameCount::GetSenderFrameInfo(SharedTextureInfoEx &info)
+{
+	if (m_FrameInfoLast.frameCount == 0)
+		return false;
+	info = m_FrameInfoLast;
+	return true;
+}
+
+// -----------------------------------------------
+// Function: WaitNewFrame
+// Receiver wait for a new sender frame.
+//
+// Wait until the sender signals a new frame or the timeout (msec) elapses,
+// whichever comes first. Can be used instead of a fixed sleep
+// before receiving to avoid polling and reduce latency.
+//
+// Similar to WaitOnAddress, which is limited to one process.
+// Block on the event while the shared frame counter is unchanged.
+//
+// The events are signalled by SetNewFrame if the sender writes extended
+// frame information. There is a manual-reset event for even and odd frame
+// counts. The sender resets the event of the following frame before the
+// counter changes and then sets the event of the new frame, so all
+// receivers waiting are released. A receiver waits on the event of the
+// frame after the count it has read, which cannot hold a signal from an
+// earlier frame. The counter is checked before each wait so that a frame
+// already sent is not missed. If two frames are sent between the check
+// and the wait, the receiver is released by the frame after.
+//
+// Returns true for a new frame, false for timeout or if the sender does
+// not signal new frames. Then the full timeout is used and the receiver
+// continues as before.
+//
+bool spoutFrameCount::WaitNewFrame(DWORD dwTimeout)
+{
+	if (!m_bFrameCount || m_bCountDisabled || !m_bFrameInfo) {
+		if (dwTimeout > 0) Sleep(dwTimeout);
+		return false;
+	}
+
+	const double deadline = GetCounterMicroseconds() + static_cast<double>(dwTimeout)*1000.0;
+	SharedTextureInfoEx info={};
+
+	do {
+		// A new frame has been sent since the last received
+		if (ReadFrameInfo(&info) && info.frameCount != m_LastFrameInfoCount)
+			return true;
+
+		const double remaining = (deadline - GetCounterMicroseconds())/1000.0;
+		if (remaining < 1.0)
+			break;
+
+		// Event of the frame after the count read
+		HANDLE hEvent = m_hNewFrameEvent[(info.frameCount + 1) % 2];
+		if (!hEvent) {
+			Sleep(static_cast<DWORD>(remaining));
+			break;
+		}
+
+		// Timeout is expected and not logged
+		const DWORD dwWaitResult = WaitForSingleObject(hEvent, static_cast<DWORD>(remaining));
+		if (dwWaitResult != WAIT_OBJECT_0) {
+			if (dwWaitResult == WAIT_FAILED)
+				SpoutLogError("spoutFrameCount::WaitNewFrame - WAIT_FAILED");
+			break;
+		}
+
+	} while (true);
+
+	// Last check in case the frame arrived at the deadline
+	return (ReadFrameInfo(&info) && info.frameCount != m_LastFrameInfoCount);
+
+}
+
+
+// HoldFps clock functions for SpoutPacerHold
+
+// Performance counter microseconds
+static double HoldClockNow(void* user)
+{
+	UNREFERENCED_PARAMETER(user);
+	return GetCounterMicroseconds();
+}
+
+// Waitable timer if created, otherwise Sleep
+static void HoldClockSleep(void* user, double usec)
+{
+	const LONGLONG sleeptime = static_cast<LONGLONG>(usec);
+	HANDLE hTimer = static_cast<HANDLE>(user);
+	if (hTimer) {
+		LARGE_INTEGER due={};
+		due.QuadPart = -sleeptime*10LL; // relative, 100 nanosecond units
+		if (SetWaitableTimer(hTimer, &due, 0, NULL, NULL, FALSE))
+			WaitForSingleObject(hTimer, INFINITE);
+	}
+	else {
+		Sleep(static_cast<DWORD>(sleeptime/1000LL));
+	}
+}
+
+// Processor pause for the spin wait
+static void HoldClockSpin(void* user)
+{
+	UNREFERENCED_PARAMETER(user);
+	YieldProcessor();
+}
 
 // -----------------------------------------------
 // Function: HoldFps
@@ -413,63 +647,75 @@ long spoutFrameCount::GetSenderFrame()
 // have frame rate control. Must be called every frame.
 // The sender will then signal a new frame at the target rate.
 //
+// Each frame has an absolute deadline one frame period after the last,
+// so that errors do not accumulate. The function sleeps until shortly
+// before the deadline and then spins for the remainder (SPOUT_HOLD_SPIN).
+// The deadline timing is in SpoutFramePacer.h, with the clock and sleep
+// functions above, and can be measured on any system with the
+// tools\SpoutHoldFps program.
+//
 // Note that this function is affected by changes to Windows timer 
 // resolution since Windows 10 Version 2004 (April 2020)
 // https://randomascii.wordpress.com/2020/10/04/windows-timer-resolution-the-great-rule-change/
 //
-// TimeBeginPeriod / TimeEndPeriod avoid loss of precision
+// A high resolution waitable timer is used if available (Windows 10 1803 and later).
+// TimeBeginPeriod / TimeEndPeriod avoid loss of precision otherwise
 // https://learn.microsoft.com/en-us/windows/win32/api/timeapi/nf-timeapi-timebeginperiod
-// Microsoft remark :
-//   Call this function immediately before using timer services, and call the timeEndPeriod
-//   function immediately after you are finished using the timer services. An application 
-//   can make multiple timeBeginPeriod calls as long as each call is matched with a call
-//   to timeEndPeriod.
+// The period is set on the first call and reset by HoldFps(0), CleanupFrameCount
+// or the class destructor, instead of being changed every frame.
 // 
 void spoutFrameCount::HoldFps(int fps)
 {
-	// Unlikely but return anyway
-	if (fps <= 0)
+	// Zero or negative ends frame rate control
+	if (fps <= 0) {
+		EndHoldFps();
+		m_NominalFps = 0.0;
 		return;
-
-	// Reduce Windows timer period to minimum
-	StartTimePeriod();
-
-	// Target frame time
-	const double target = (1000000.0/static_cast<double>(fps))/1000.0; // msec
-
-#ifdef USE_CHRONO
-
-	// Time now end point
-	*m_FrameEndPtr = std::chrono::steady_clock::now();
-
-	// Milliseconds elapsed
-	const double elapsedTime = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(*m_FrameEndPtr - *m_FrameStartPtr).count()/1000000.0);
-
-	// Sleep to reach the target frame time
-	if (elapsedTime < target) {
-		std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(target - elapsedTime)));
 	}
 
-	// Set start time for the next frame
-	*m_FrameStartPtr = std::chrono::steady_clock::now();
-
-#else
-
-	// Milliseconds elapsed
-	double elapsedTime = EndTiming();
-
-	// Sleep to reach the target frame time
-	if (elapsedTime < target)
-		Sleep((DWORD)(target - elapsedTime));
-
-	// Set start time for the next frame
-	StartTiming();
+	// The rate held is the nominal sender frame rate
+	m_NominalFps = static_cast<double>(fps);
+
+	// Target frame time (microseconds)
+	const double period = SpoutPacerPeriod(fps);
+
+	// Performance counter, waitable timer and processor pause
+	SpoutPacerClock clock = { HoldClockNow, HoldClockSleep, HoldClockSpin, nullptr };
+
+	// Start a new session for the first call or a change of frame rate.
+	// The timer period and waitable timer are held for the session
+	// rather than changed every frame.
+	if (fps != m_HoldFps || m_HoldDeadline <= 0.0) {
+		if (m_PeriodMin == 0)
+			StartTimePeriod();
+		if (!m_hHoldTimer) {
+			// High resolution timer for Windows 10 1803 and later
+			m_hHoldTimer = CreateWaitableTimerExW(NULL, NULL,
+				CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+			if (!m_hHoldTimer)
+				m_hHoldTimer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+		}
+		m_HoldFps = fps;
+		m_HoldDeadline = SpoutPacerStart(period, clock);
+		return;
+	}
 
-#endif
+	// Wait for this frame's deadline and carry it forward to the next
+	clock.user = m_hHoldTimer;
+	m_HoldDeadline = SpoutPacerHold(m_HoldDeadline, period, clock);
 
-	// Reset Windows timer period
-	EndTimePeriod();
+}
 
+// -----------------------------------------------
+// Function: SetNominalFps
+// Nominal sender frame rate
+//
+// Written to the extended frame information for receivers.
+// Set by a sender that knows its frame rate. HoldFps sets the rate
+// held. Zero or negative if unknown.
+void spoutFrameCount::SetNominalFps(double fps)
+{
+	m_NominalFps = (fps > 0.0) ? fps : 0.0;
 }
 
 // -----------------------------------------------
@@ -484,7 +730,14 @@ void spoutFrameCount::HoldFps(int fps)
 void spoutFrameCount::SetNewFrame()
 {
 	// Return silently if frame counting is disabled
-	if (!m_bFrameCount || m_bCountDisabled || !m_hCountSemaphore)
+	if (!m_bFrameCount || m_bCountDisabled)
+		return;
+
+	// Update the extended sender frame information
+	// and wake receivers waiting for a new frame
+	WriteFrameInfo();
+
+	if (!m_hCountSemaphore)
 		return;
 
 	// Access the frame count semaphore
@@ -543,6 +796,32 @@ bool spoutFrameCount::GetNewFrame()
 	if (!m_bFrameCount || m_bCountDisabled)
 		return true;
 
+	// If the sender writes extended frame information,
+	// use the frame counter instead of the semaphore count.
+	// For version 3 and later this is a lock-free read
+	// of the counter and does not require any kernel calls.
+	SharedTextureInfoEx info={};
+	if (ReadFrameInfo(&info)) {
+		if (info.frameCount != m_LastFrameInfoCount) {
+			m_FrameCount = static_cast<long>(info.frameCount);
+			m_bIsNewFrame = true;
+			// Time from the sender capture time stamp
+			m_SenderLatency = (GetCounterMicroseconds() - static_cast<double>(info.timestamp))/1000.0;
+			// Update the sender fps calculations (see below)
+			if (m_LastFrameInfoCount > 0)
+				UpdateSenderFps(static_cast<long>(info.frameCount - m_LastFrameInfoCount));
+			m_LastFrameInfoCount = info.frameCount;
+			return true;
+		}
+		// The same frame. If the information has not been updated
+		// for more than a second, a sender of the same name might
+		// not be writing it, so check the semaphore as well.
+		if ((GetCounterMicroseconds() - static_cast<double>(info.timestamp)) < 1000000.0) {
+			m_bIsNewFrame = false;
+			return false;
+		}
+	}
+
 	// A receiver creates or opens a named semaphore when it connects to a sender
 	// Do not block if semaphore creation failed so that ReceiveTexture can still be called
 	if (!m_hCountSemaphore) {
@@ -624,10 +903,18 @@ void spoutFrameCount::CleanupFrameCount()
 		if (m_hAccessMutex) CloseHandle(m_hAccessMutex);
 		m_hAccessMutex = NULL;
 
+		// Close the extended sender frame information map
+		// and the new frame event
+		CloseFrameInfo();
+		CloseNewFrameEvent();
+
 		// Close the sync event
 		// Also closed in sender/receiver release
 		CloseFrameSync();
 
+		// End frame rate control
+		EndHoldFps();
+
 		// Clear the sender name in case the same one opens again
 		m_SenderName[0] = 0;
 
@@ -638,6 +925,10 @@ void spoutFrameCount::CleanupFrameCount()
 		m_FrameTimeTotal = 0.0;
 		m_FrameTimeNumber = 0.0;
 		m_SenderFps = m_SystemFps; // Default sender fps is system refresh rate
+		m_NominalFps = 0.0;
+		m_LastFrameInfoCount = 0;
+		m_SenderLatency = 0.0;
+		ResetFrameIntervals();
 	}
 	catch (...) {
 		SpoutLogError("SpoutFrameCount::CleanupFrameCount caused an exception");
@@ -1051,35 +1342,14 @@ void spoutFrameCount::UpdateSenderFps(long framecount)
 		m_FrameTime = thisFrame - m_lastFrame;
 #endif
 		
-		if (m_FrameTime > 1.0) { // > 1 msec
-
-			// Frame time in seconds 
-			double frametime = m_FrameTime/1000.0;
-
-			// Accumulate totals
-			m_FrameTimeTotal = m_FrameTimeTotal + frametime;
-
-			// Could have been more than one frame
-			m_FrameTimeNumber += static_cast<double>(framecount);
-
-			if (m_FrameTimeNumber > 8) {
-				// Calculate average frames per second and m_SenderFps
-				// (default fps is system refresh rate)
-				const double avgframetime = m_FrameTimeTotal/m_FrameTimeNumber;
-				if (avgframetime > 0.0001) {
-					const double fps2 = (1.0 / avgframetime);
-					// Damping to stabilise
-					m_SenderFps = 0.95*m_SenderFps + 0.05*fps2;
-				}
-				m_FrameTimeTotal = 0.0;
-				m_FrameTimeNumber = 0.0;
-			}
-
-		}
+		// Record the frame interval and update the sender fps
+		// (default fps is system refresh rate)
+		AddFrameInterval(m_FrameTime, framecount);
 
 // Set the start time for the next frame
+// Use the end time so that intervals do not exclude the time taken here
 #ifdef USE_CHRONO
-		*m_FpsStartPtr = std::chrono::steady_clock::now();
+		*m_FpsStartPtr = *m_FpsEndPtr;
 #else
 		m_lastFrame = thisFrame;
 #endif
@@ -1098,6 +1368,281 @@ void spoutFrameCount::UpdateSenderFps(long framecount)
 }
 
 
+// -----------------------------------------------
+// Clear the sender frame interval window and statistics
+void spoutFrameCount::ResetFrameIntervals()
+{
+	for (int i = 0; i < SPOUT_FPS_WINDOW; i++)
+		m_FrameIntervals[i] = 0.0;
+	m_FrameIntervalIndex = 0;
+	m_FrameIntervalCount = 0;
+	m_FrameJitter = 0.0;
+	m_FrameIntervalMin = 0.0;
+	m_FrameIntervalMax = 0.0;
+	m_FrameBurstCount = 0L;
+}
+
+// -----------------------------------------------
+// Add a frame interval (msec) to the window and update statistics
+//
+// If the sender produced more than one frame since the last,
+// the interval is divided between them.
+//
+// Intervals within the last second (at least 8, at most SPOUT_FPS_WINDOW)
+// are sorted and the highest and lowest quarter discarded. The mean of the
+// remainder is not affected by occasional late or early frames but follows
+// a change of sender frame rate within a second.
+//
+// Intervals longer than a second are a sender pause and start a new window.
+void spoutFrameCount::AddFrameInterval(double interval, long framecount)
+{
+	if (interval <= 0.0 || framecount <= 0)
+		return;
+
+	if (interval > 1000.0) {
+		m_FrameIntervalIndex = 0;
+		m_FrameIntervalCount = 0;
+		return;
+	}
+
+	const double frametime = interval/static_cast<double>(framecount);
+	const long nframes = (framecount < SPOUT_FPS_WINDOW) ? framecount : SPOUT_FPS_WINDOW;
+	for (long i = 0; i < nframes; i++) {
+		m_FrameIntervals[m_FrameIntervalIndex] = frametime;
+		m_FrameIntervalIndex = (m_FrameIntervalIndex + 1) % SPOUT_FPS_WINDOW;
+		if (m_FrameIntervalCount < SPOUT_FPS_WINDOW)
+			m_FrameIntervalCount++;
+	}
+
+	// Collect the most recent intervals within one second
+	double window[SPOUT_FPS_WINDOW]={};
+	double span = 0.0;
+	double sum = 0.0;
+	double minimum = m_FrameIntervals[(m_FrameIntervalIndex + SPOUT_FPS_WINDOW - 1) % SPOUT_FPS_WINDOW];
+	double maximum = minimum;
+	int n = 0;
+	int index = m_FrameIntervalIndex;
+	while (n < m_FrameIntervalCount) {
+		index = (index + SPOUT_FPS_WINDOW - 1) % SPOUT_FPS_WINDOW;
+		const double value = m_FrameIntervals[index];
+		if (n >= 8 && span + value > 1000.0)
+			break;
+		span += value;
+		sum += value;
+		if (value < minimum) minimum = value;
+		if (value > maximum) maximum = value;
+		window[n++] = value;
+	}
+
+	if (n < 8)
+		return;
+
+	// Trimmed mean of the middle half.
+	// The window is partitioned instead of sorted for every frame.
+	// Intervals before "first" are the shortest quarter, those from
+	// "last" the longest quarter, and the median is between.
+	const int first = n/4;
+	const int last  = n - n/4;
+	std::nth_element(window, window + first, window + n);
+	std::nth_element(window + first, window + last, window + n);
+	std::nth_element(window + first, window + n/2, window + last);
+	double trimmed = 0.0;
+	for (int i = first; i < last; i++)
+		trimmed += window[i];
+	trimmed /= static_cast<double>(last - first);
+
+	// Jitter is the standard deviation of all intervals in the window
+	const double mean = sum/static_cast<double>(n);
+	double variance = 0.0;
+	for (int i = 0; i < n; i++)
+		variance += (window[i] - mean)*(window[i] - mean);
+	m_FrameJitter = sqrt(variance/static_cast<double>(n));
+
+	m_FrameIntervalMin = minimum;
+	m_FrameIntervalMax = maximum;
+
+	// A frame that arrives in less than half the median interval
+	// follows the last one too closely.
+	if (frametime < 0.5*window[n/2])
+		m_FrameBurstCount++;
+
+	if (trimmed > 0.1)
+		m_SenderFps = 1000.0/trimmed;
+
+}
+
+// -----------------------------------------------
+// Create or open the extended sender frame information map
+//
+// Either the sender or receiver can create it.
+// A new map is initially zeros and the frame count remains
+// zero unless the sender updates it with WriteFrameInfo.
+void spoutFrameCount::OpenFrameInfo(const char* SenderName)
+{
+	if (!SenderName || !*SenderName)
+		return;
+
+	char szName[256]={};
+	sprintf_s(szName, 256, "%s_FrameInfo", SenderName);
+
+	// Return if already open for this sender
+	if (m_bFrameInfo) {
+		if (m_FrameInfo.Name() && strcmp(m_FrameInfo.Name(), szName) == 0)
+			return;
+		CloseFrameInfo();
+	}
+
+	const SpoutCreateResult result = m_FrameInfo.Create(szName, sizeof(SharedTextureInfoEx));
+	if (result == SPOUT_CREATE_FAILED) {
+		SpoutLogWarning("    could not create frame information [%s]", szName);
+		return;
+	}
+
+	if (result == SPOUT_ALREADY_EXISTS)
+		SpoutLogNotice("    frame information [%s] exists", szName);
+	else
+		SpoutLogNotice("    frame information [%s] created", szName);
+
+	m_bFrameInfo = true;
+	m_LastFrameInfoCount = 0;
+
+}
+
+// -----------------------------------------------
+// Close the extended sender frame information map
+// If another application has the map open it will not be finally closed here.
+void spoutFrameCount::CloseFrameInfo()
+{
+	if (m_bFrameInfo)
+		m_FrameInfo.Close();
+	m_bFrameInfo = false;
+	m_bAtomicCount = false;
+	m_FrameInfoLast = {};
+}
+
+// -----------------------------------------------
+// Sender - increment the frame counter and
+// record the capture time and nominal frame rate
+// The rate is set by SetNominalFps or HoldFps and is zero if unknown.
+void spoutFrameCount::WriteFrameInfo()
+{
+	if (!m_bFrameInfo)
+		return;
+
+	SharedTextureInfoEx* pInfo = reinterpret_cast<SharedTextureInfoEx*>(m_FrameInfo.Buffer());
+	if (!pInfo)
+		return;
+
+	// Only the sender changes the counter
+	const uint64_t count = ReadAtomic64(&pInfo->frameCount) + 1;
+
+	// Reset the event of the frame after this one before the counter
+	// changes, so that a receiver that reads the new count and waits
+	// for the next frame does not find a signal from an earlier frame.
+	if (m_hNewFrameEvent[(count + 1) % 2])
+		ResetEvent(m_hNewFrameEvent[(count + 1) % 2]);
+
+	// The frame details are written first and the counter is incremented
+	// last so that a receiver that finds a new count reads them for that frame.
+	// The interlocked operations are full memory barriers.
+	pInfo->size = sizeof(SharedTextureInfoEx);
+	pInfo->version = SPOUT_FRAMEINFO_VERSION;
+	pInfo->fps = static_cast<uint32_t>(m_NominalFps*1000.0 + 0.5);
+	InterlockedExchange64(reinterpret_cast<volatile LONG64*>(&pInfo->timestamp),
+		static_cast<LONG64>(GetCounterMicroseconds()));
+	InterlockedIncrement64(reinterpret_cast<volatile LONG64*>(&pInfo->frameCount));
+
+	// Release all receivers waiting for this frame
+	if (m_hNewFrameEvent[count % 2])
+		SetEvent(m_hNewFrameEvent[count % 2]);
+}
+
+// -----------------------------------------------
+// Receiver - read the sender frame information
+// Returns false if the map is not open or the sender has not written to it
+bool spoutFrameCount::ReadFrameInfo(SharedTextureInfoEx* info)
+{
+	if (!m_bFrameInfo || !info)
+		return false;
+
+	const volatile SharedTextureInfoEx* pInfo = reinterpret_cast<const volatile SharedTextureInfoEx*>(m_FrameInfo.Buffer());
+	if (!pInfo)
+		return false;
+
+	// A map created by the receiver for a sender that does not
+	// write to it remains zero. Return without locking the map
+	// so that the receiver uses the frame count semaphore.
+	m_bAtomicCount = (pInfo->version >= SPOUT_FRAMEINFO_ATOMIC);
+	if (!m_bAtomicCount)
+		return false;
+
+	// Lock-free read. The details are read between two reads
+	// of the counter and read again if the sender has changed them.
+	for (int i = 0; i < 4; i++) {
+		info->frameCount = ReadAtomic64(&pInfo->frameCount);
+		info->size       = pInfo->size;
+		info->version    = pInfo->version;
+		info->timestamp  = ReadAtomic64(&pInfo->timestamp);
+		info->fps        = pInfo->fps;
+		if (ReadAtomic64(&pInfo->frameCount) == info->frameCount)
+			break;
+	}
+
+	if (info->size < sizeof(SharedTextureInfoEx) || info->frameCount == 0)
+		return false;
+
+	m_FrameInfoLast = *info;
+
+	return true;
+}
+
+// -----------------------------------------------
+// Create or open the new frame events
+//
+// Manual-reset events for even and odd frame counts.
+// The sender sets the event of each new frame and resets
+// the event of the frame after (see WriteFrameInfo).
+// Either the sender or receiver can create them.
+void spoutFrameCount::OpenNewFrameEvent(const char* SenderName)
+{
+	if (!SenderName || !*SenderName)
+		return;
+
+	// Close any existing events for a new sender
+	CloseNewFrameEvent();
+
+	for (int i = 0; i < 2; i++) {
+		char szName[256]={};
+		sprintf_s(szName, 256, "%s_NewFrame_Event_%d", SenderName, i);
+		HANDLE hEvent = CreateEventA(
+			NULL,  // Attributes
+			TRUE,  // Manual reset
+			FALSE, // Initial state non-signalled
+			szName);
+		if (!hEvent) {
+			SpoutLogWarning("    could not create new frame event [%s]", szName);
+			CloseNewFrameEvent();
+			return;
+		}
+		if (GetLastError() == ERROR_ALREADY_EXISTS)
+			SpoutLogNotice("    new frame event [%s] exists", szName);
+		else
+			SpoutLogNotice("    new frame event [%s] created", szName);
+		m_hNewFrameEvent[i] = hEvent;
+	}
+}
+
+// -----------------------------------------------
+// Close the new frame events
+void spoutFrameCount::CloseNewFrameEvent()
+{
+	for (int i = 0; i < 2; i++) {
+		if (m_hNewFrameEvent[i])
+			CloseHandle(m_hNewFrameEvent[i]);
+		m_hNewFrameEvent[i] = NULL;
+	}
+}
+
 // -----------------------------------------------
 // Reduce Windows timing period to the minimum
 // supported by the system (usually 1 msec)
@@ -1114,6 +1659,19 @@ void spoutFrameCount::StartTimePeriod()
 }
 
 
+// -----------------------------------------------
+// End a HoldFps session
+// Reset the Windows timing period and close the timer
+void spoutFrameCount::EndHoldFps()
+{
+	EndTimePeriod();
+	if (m_hHoldTimer)
+		CloseHandle(m_hHoldTimer);
+	m_hHoldTimer = NULL;
+	m_HoldFps = 0;
+	m_HoldDeadline = 0.0;
+}
+
 // -----------------------------------------------
 // Reset Windows timing period
 void spoutFrameCount::EndTimePeriod()
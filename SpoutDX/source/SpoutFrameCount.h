@@ -33,6 +33,8 @@
 
 #include "SpoutCommon.h"
 #include "SpoutSharedMemory.h"
+#include "SpoutSenderNames.h" // for SharedTextureInfoEx
+#include "SpoutFramePacer.h" // for HoldFps
 
 #include <string>
 #include <vector>
@@ -42,6 +44,14 @@
 
 using namespace spoututils;
 
+// Maximum number of frame intervals for the sender fps estimate
+#define SPOUT_FPS_WINDOW 240
+
+// For SDKs before Windows 10 1803
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
 // USE_CHRONO is defined in SpoutUtils.h
 // Note comments about using an early platform toolset
 #ifdef USE_CHRONO
@@ -76,8 +86,24 @@ class SPOUT_DLLEXP spoutFrameCount {
 	double GetSenderFps();
 	// Received frame count
 	long GetSenderFrame();
+	// Sender to receiver latency of the last new frame (msec)
+	double GetSenderLatency();
+	// Sender frame interval jitter (msec)
+	double GetSenderFrameJitter();
+	// Minimum sender frame interval (msec)
+	double GetSenderFrameIntervalMin();
+	// Maximum sender frame interval (msec)
+	double GetSenderFrameIntervalMax();
+	// Number of sender frame bursts
+	long GetSenderBurstCount();
+	// Extended sender frame information last received
+	bool GetSenderFrameInfo(SharedTextureInfoEx &info);
+	// Wait for a new sender frame or timeout
+	bool WaitNewFrame(DWORD dwTimeout);
 	// Frame rate control
 	void HoldFps(int fps);
+	// Nominal sender frame rate for receivers, zero if unknown
+	void SetNominalFps(double fps);
 
 	//
 	// Used by other classes
@@ -155,16 +181,51 @@ protected:
 	double m_FrameTimeNumber;
 	double m_lastFrame;
 
+	// Extended sender frame information map
+	SpoutSharedMemory m_FrameInfo;
+	bool m_bFrameInfo; // map is open
+	SharedTextureInfoEx m_FrameInfoLast; // last received
+	uint64_t m_LastFrameInfoCount; // receiver frame comparator
+	double m_SenderLatency; // msec
+	bool m_bAtomicCount; // sender updates the frame counter atomically
+	void OpenFrameInfo(const char* SenderName);
+	void CloseFrameInfo();
+	void WriteFrameInfo();
+	bool ReadFrameInfo(SharedTextureInfoEx* info);
+
+	// New frame events for even and odd frame counts
+	HANDLE m_hNewFrameEvent[2];
+	void OpenNewFrameEvent(const char* SenderName);
+	void CloseNewFrameEvent();
+
 	// Sender frame timing
 	double m_SystemFps;
 	double m_SenderFps;
+	double m_NominalFps; // Sender nominal rate (SetNominalFps or HoldFps)
 	void UpdateSenderFps(long framecount = 0);
 
+	// Sender frame interval window and statistics
+	double m_FrameIntervals[SPOUT_FPS_WINDOW]; // msec
+	int m_FrameIntervalIndex; // next entry
+	int m_FrameIntervalCount; // number of entries
+	double m_FrameJitter;
+	double m_FrameIntervalMin;
+	double m_FrameIntervalMax;
+	long m_FrameBurstCount;
+	void ResetFrameIntervals();
+	void AddFrameInterval(double interval, long framecount);
+
 	// Windows minimum time period
 	UINT m_PeriodMin;
 	void StartTimePeriod();
 	void EndTimePeriod();
 
+	// HoldFps session
+	int m_HoldFps; // frame rate
+	double m_HoldDeadline; // next frame deadline (microseconds)
+	HANDLE m_hHoldTimer; // waitable timer
+	void EndHoldFps();
+
 	// Sync event
 	bool m_bFrameSync;
 	HANDLE m_hSyncEvent;
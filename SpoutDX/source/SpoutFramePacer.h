@@ -0,0 +1,162 @@
+/*
+
+					SpoutFramePacer.h
+
+		Frame deadline timing for HoldFps
+
+		Each frame has an absolute deadline one frame period after the last,
+		so that errors do not accumulate. The wait sleeps until shortly before
+		the deadline and then spins for the remainder.
+
+		The spin time can be fixed or adapted to the late return of
+		the sleep measured for each frame (SpoutPacerAdapt).
+
+		The clock, sleep and spin functions are supplied by the caller.
+		spoutFrameCount::HoldFps uses the performance counter and a high
+		resolution waitable timer. Other clocks can be used to measure
+		the timing on any system or to test it with a simulated clock.
+
+		The functions have no Windows dependency.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification,
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice,
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice,
+		   this list of conditions and the following disclaimer in the documentation
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+	SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+	OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+	HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+	OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+#ifndef __SpoutFramePacer__ // standalone define
+#define __SpoutFramePacer__
+
+// Spin time before the frame deadline (microseconds)
+// Allows for sleep functions that return late.
+#ifndef SPOUT_HOLD_SPIN
+#define SPOUT_HOLD_SPIN 500.0
+#endif
+
+//
+// Clock functions supplied by the caller
+//
+//   now   - time in microseconds
+//   sleep - sleep for at least the time given in microseconds
+//   spin  - one iteration of the spin wait, e.g. a processor pause
+//   user  - passed to each function
+//
+struct SpoutPacerClock {
+	double (*now)(void* user);
+	void (*sleep)(void* user, double usec);
+	void (*spin)(void* user);
+	void* user;
+};
+
+//
+// Frame period in microseconds for a frame rate
+//
+inline double SpoutPacerPeriod(int fps)
+{
+	return (fps > 0) ? 1000000.0/static_cast<double>(fps) : 0.0;
+}
+
+//
+// First deadline of a session, one period from now
+//
+inline double SpoutPacerStart(double period, const SpoutPacerClock& clock)
+{
+	return clock.now(clock.user) + period;
+}
+
+//
+// Wait for a frame deadline and return the next one
+//
+//   deadline  - time of this frame (microseconds)
+//   period    - frame period (microseconds)
+//   spin      - time before the deadline to stop sleeping and spin
+//   overshoot - optional, returns the time the sleep returned late
+//               (microseconds) or a negative value if there was no sleep
+//
+// The next deadline follows from this one and not from the time now,
+// so that any drift is corrected by the next frame. If the caller is
+// more than a frame late, it has stalled and the next deadline starts
+// again from now instead of returning early for the frames missed.
+//
+inline double SpoutPacerHold(double deadline, double period,
+	const SpoutPacerClock& clock, double spin = SPOUT_HOLD_SPIN,
+	double* overshoot = nullptr)
+{
+	if (overshoot)
+		*overshoot = -1.0;
+
+	const double remaining = deadline - clock.now(clock.user);
+	if (remaining > 0.0) {
+		// Sleep coarsely until close to the deadline
+		if (remaining > spin) {
+			clock.sleep(clock.user, remaining - spin);
+			if (overshoot) {
+				const double late = clock.now(clock.user) - (deadline - spin);
+				*overshoot = (late > 0.0) ? late : 0.0;
+			}
+		}
+		// Spin for the remainder
+		while (clock.now(clock.user) < deadline)
+			clock.spin(clock.user);
+	}
+
+	deadline += period;
+
+	const double now = clock.now(clock.user);
+	if (deadline < now)
+		deadline = now + period;
+
+	return deadline;
+}
+
+//
+// Adapt the spin time to the sleep overshoot returned by SpoutPacerHold
+//
+//   spin      - current spin time (microseconds)
+//   overshoot - late return of the last sleep, negative if none
+//   period    - frame period (microseconds)
+//
+// A sleep that returns later than the spin time allows would miss the
+// deadline, so the spin time is raised at once to a quarter more than
+// the overshoot. It then falls slowly back towards SPOUT_HOLD_SPIN while
+// the sleep returns in time. The spin time is at most half the period.
+//
+inline double SpoutPacerAdapt(double spin, double overshoot, double period)
+{
+	if (overshoot < 0.0)
+		return spin;
+
+	const double target = overshoot*1.25 + 100.0;
+	if (target > spin)
+		spin = target;
+	else
+		spin -= (spin - target)/256.0;
+
+	if (spin < SPOUT_HOLD_SPIN)
+		spin = SPOUT_HOLD_SPIN;
+	if (spin > period/2.0)
+		spin = period/2.0;
+	return spin;
+}
+
+#endif
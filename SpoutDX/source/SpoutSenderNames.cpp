@@ -110,6 +110,7 @@
 	Version 2.007.014
 	20.06.24 - Add GetSenderIndex
 	23.08.24 - GetSenderInfo, SetSenderID - initialize SharedTextureInfo
+	19.10.26 - Add SharedTextureInfoEx extended sender information to header
 
 
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
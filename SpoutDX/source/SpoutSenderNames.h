@@ -79,6 +79,37 @@ struct SharedTextureInfo {		// 280 bytes total
 	uint32_t partnerId;			// 4 bytes : ID
 };
 
+//
+// Extended sender information
+//
+// Saved to a separate shared memory map "<sendername>_FrameInfo" so that
+// the 280 byte SharedTextureInfo structure is unchanged for existing
+// senders and receivers. The map is created with the frame count semaphore
+// and updated by the sender for every frame (see SpoutFrameCount).
+// A receiver that does not find the map, or finds a zero frame count,
+// uses the frame count semaphore as before.
+//
+// Time stamps are microseconds from the system performance counter
+// which is consistent between processes (see GetCounterMicroseconds).
+//
+// From version 3 the sender writes the frame details and then increments
+// the 64 bit frame counter with an interlocked operation. A receiver reads
+// the counter without locking the map and does not use the semaphore.
+// The sender still increments the semaphore for receivers of earlier versions.
+// The structure must be at the start of the map for 8 byte alignment.
+//
+#define SPOUT_FRAMEINFO_VERSION 3
+#define SPOUT_FRAMEINFO_ATOMIC  3 // first version with atomic counter
+
+struct SharedTextureInfoEx {	// 40 bytes total
+	uint32_t size;				// 4 bytes : structure size
+	uint32_t version;			// 4 bytes : structure version
+	uint64_t frameCount;		// 8 bytes : sender frame counter
+	uint64_t timestamp;			// 8 bytes : sender capture time (microseconds)
+	uint32_t fps;				// 4 bytes : nominal sender frame rate x 1000, zero if unknown
+	uint32_t reserved[3];		// 12 bytes : unused
+};
+
 //
 // GUIDs for additional sender information maps
 // Used for development work
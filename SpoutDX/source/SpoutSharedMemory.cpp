@@ -53,6 +53,7 @@
 //	07.12.23 - Remove unused <d3d9.h> from header
 //	Version 2.007.013
 //	Version 2.007.014
+//	19.10.26 - Add Buffer for lock-free access to an open map
 //
 // ====================================================================================
 
@@ -300,6 +301,16 @@ void SpoutSharedMemory::Unlock()
 	}
 }
 
+//---------------------------------------------------------
+// Function: Buffer
+// Return the buffer of an open map without locking.
+// For data that is written and read with atomic operations,
+// otherwise use Lock and Unlock.
+char* SpoutSharedMemory::Buffer()
+{
+	return m_pBuffer;
+}
+
 //---------------------------------------------------------
 // Function: Name
 // Return the name of an existing map
@@ -74,6 +74,9 @@ public:
 	// Unlock a map
 	void Unlock();
 
+	// Buffer of an open map without locking
+	char* Buffer();
+
 	// Name of an existing map
 	const char* Name();
 	
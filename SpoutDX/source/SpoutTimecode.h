@@ -0,0 +1,286 @@
+/*
+
+					SpoutTimecode.h
+
+		Timecode watermark for latency measurement
+
+		A block of black and white cells in the top left corner of a frame
+		holds the sender frame number and capture time. The cells survive
+		scaling and compression by the receiving application, so the frame
+		can be identified again in a recording or a dump of raw frames and
+		the capture time compared with the time it was received.
+
+		The capture time is microseconds of the system performance counter
+		(spoututils::GetCounterMicroseconds), which is the same for all
+		processes, so the receiving application can record its own time
+		for each frame on the same base.
+
+		Block layout, 16 x 8 cells of "cell" pixels each :
+
+			Row 0       - clock, alternate white and black cells
+			Column 0    - clock, alternate white and black cells
+			Rows 1-7    - 96 data bits in columns 1-15, row by row,
+			              most significant bit of each byte first.
+			              White is 1 and black is 0.
+
+		Data bytes :
+
+			0 - 3   - frame number (low 32 bits, little endian)
+			4 - 9   - capture time (low 48 bits of microseconds, little endian)
+			10 - 11 - CRC-16/CCITT of bytes 0 - 9
+
+		The functions have no Windows dependency and are shared by the
+		receiver that writes the block and the decoder that reads it.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+	Copyright (c) 2026, Lynn Jarvis. All rights reserved.
+
+	Redistribution and use in source and binary forms, with or without modification,
+	are permitted provided that the following conditions are met:
+
+		1. Redistributions of source code must retain the above copyright notice,
+		   this list of conditions and the following disclaimer.
+
+		2. Redistributions in binary form must reproduce the above copyright notice,
+		   this list of conditions and the following disclaimer in the documentation
+		   and/or other materials provided with the distribution.
+
+	THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+	EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+	OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+	SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+	SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+	OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+	HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+	OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+	SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+#ifndef __SpoutTimecode__ // standalone define
+#define __SpoutTimecode__
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Block size in cells
+#define SPOUT_TIMECODE_COLUMNS 16
+#define SPOUT_TIMECODE_ROWS 8
+
+// Default cell size in pixels
+#define SPOUT_TIMECODE_CELL 4
+
+// Largest cell size searched by SpoutTimecodeRead
+#define SPOUT_TIMECODE_MAXCELL 64
+
+// Data bytes including the CRC
+#define SPOUT_TIMECODE_BYTES 12
+
+// Capture time bits
+#define SPOUT_TIMECODE_TIMEMASK 0xFFFFFFFFFFFFULL
+
+//
+// CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF)
+//
+inline uint16_t SpoutTimecodeCRC(const uint8_t* data, size_t size)
+{
+	uint16_t crc = 0xFFFF;
+	for (size_t i = 0; i < size; i++) {
+		crc ^= static_cast<uint16_t>(data[i] << 8);
+		for (int b = 0; b < 8; b++)
+			crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+	}
+	return crc;
+}
+
+//
+// Cell value (0 black or 1 white) of the block for the data bytes
+//
+inline int SpoutTimecodeCell(const uint8_t* bytes, unsigned int row, unsigned int column)
+{
+	// Clock row and column
+	if (row == 0)
+		return (column & 1) ? 0 : 1;
+	if (column == 0)
+		return (row & 1) ? 0 : 1;
+	// Data bits, unused cells are black
+	const unsigned int bit = (row - 1)*(SPOUT_TIMECODE_COLUMNS - 1) + (column - 1);
+	if (bit >= SPOUT_TIMECODE_BYTES*8)
+		return 0;
+	return (bytes[bit/8] >> (7 - bit%8)) & 1;
+}
+
+//
+// Data bytes for a frame number and capture time
+//
+inline void SpoutTimecodeBytes(uint32_t frame, uint64_t time, uint8_t* bytes)
+{
+	for (int i = 0; i < 4; i++)
+		bytes[i] = static_cast<uint8_t>(frame >> (i*8));
+	for (int i = 0; i < 6; i++)
+		bytes[4 + i] = static_cast<uint8_t>(time >> (i*8));
+	const uint16_t crc = SpoutTimecodeCRC(bytes, 10);
+	bytes[10] = static_cast<uint8_t>(crc);
+	bytes[11] = static_cast<uint8_t>(crc >> 8);
+}
+
+//
+// Write the block to the top left of an image
+//
+//   data  - first row of the image as displayed
+//   pitch - bytes from one displayed row to the next,
+//           negative for an image stored bottom up
+//   bpp   - bytes per pixel, 3 or 4. Cells are written to all
+//           colour bytes and alpha is opaque.
+//   cell  - cell size in pixels
+//
+// Returns false if the image is too small for the block.
+//
+inline bool SpoutTimecodeWrite(uint8_t* data, unsigned int width, unsigned int height,
+	ptrdiff_t pitch, unsigned int bpp, uint32_t frame, uint64_t time,
+	unsigned int cell = SPOUT_TIMECODE_CELL)
+{
+	if (!data || cell == 0 || (bpp != 3 && bpp != 4)
+		|| width < SPOUT_TIMECODE_COLUMNS*cell || height < SPOUT_TIMECODE_ROWS*cell)
+		return false;
+
+	uint8_t bytes[SPOUT_TIMECODE_BYTES];
+	SpoutTimecodeBytes(frame, time, bytes);
+
+	for (unsigned int y = 0; y < SPOUT_TIMECODE_ROWS*cell; y++) {
+		uint8_t* dst = data + static_cast<ptrdiff_t>(y)*pitch;
+		for (unsigned int column = 0; column < SPOUT_TIMECODE_COLUMNS; column++) {
+			const uint8_t value = SpoutTimecodeCell(bytes, y/cell, column) ? 0xFF : 0x00;
+			for (unsigned int x = 0; x < cell; x++) {
+				dst[0] = value;
+				dst[1] = value;
+				dst[2] = value;
+				if (bpp == 4) dst[3] = 0xFF;
+				dst += bpp;
+			}
+		}
+	}
+	return true;
+}
+
+//
+// Luminance of a pixel
+//
+//   step     - bytes per sample, e.g. 4 for RGBA, 2 for YUY2, 1 for NV12
+//   channels - 3 to average RGB bytes or 1 for a luminance byte
+//
+inline unsigned int SpoutTimecodeLuma(const uint8_t* data, ptrdiff_t pitch,
+	unsigned int step, unsigned int channels, unsigned int x, unsigned int y)
+{
+	const uint8_t* p = data + static_cast<ptrdiff_t>(y)*pitch + static_cast<ptrdiff_t>(x)*step;
+	if (channels < 3)
+		return p[0];
+	return (p[0] + p[1] + p[2])/3;
+}
+
+//
+// Read the block from the top left of an image
+//
+//   data     - first row of the image as displayed
+//   pitch    - bytes from one displayed row to the next,
+//              negative for an image stored bottom up
+//   step     - bytes per sample, e.g. 4 for RGBA, 2 for YUY2, 1 for NV12
+//   channels - 3 to average RGB bytes or 1 for a luminance byte
+//   cell     - cell size to find. Zero to search all sizes
+//              up to SPOUT_TIMECODE_MAXCELL. Returns the size found.
+//
+// The centre of each cell is averaged and compared with a threshold
+// between the clock cells, so that full and limited range images,
+// scaled images and compression noise are all decoded.
+//
+// Returns false if there is no block with a valid CRC.
+//
+inline bool SpoutTimecodeRead(const uint8_t* data, unsigned int width, unsigned int height,
+	ptrdiff_t pitch, unsigned int step, unsigned int channels,
+	uint32_t &frame, uint64_t &time, unsigned int &cell)
+{
+	if (!data || step == 0)
+		return false;
+
+	unsigned int first = 1;
+	unsigned int last = SPOUT_TIMECODE_MAXCELL;
+	if (cell > 0)
+		first = last = cell;
+
+	for (unsigned int size = first; size <= last; size++) {
+
+		if (width < SPOUT_TIMECODE_COLUMNS*size || height < SPOUT_TIMECODE_ROWS*size)
+			break;
+
+		// Average of the centre half of each cell
+		unsigned int level[SPOUT_TIMECODE_ROWS][SPOUT_TIMECODE_COLUMNS];
+		const unsigned int inset = size/4;
+		const unsigned int span = size - inset*2;
+		for (unsigned int row = 0; row < SPOUT_TIMECODE_ROWS; row++) {
+			for (unsigned int column = 0; column < SPOUT_TIMECODE_COLUMNS; column++) {
+				unsigned int sum = 0;
+				for (unsigned int y = 0; y < span; y++) {
+					for (unsigned int x = 0; x < span; x++)
+						sum += SpoutTimecodeLuma(data, pitch, step, channels,
+							column*size + inset + x, row*size + inset + y);
+				}
+				level[row][column] = sum/(span*span);
+			}
+		}
+
+		// Threshold half way between the white and black clock cells
+		// The darkest white clock cell must be clearly brighter than the brightest black
+		unsigned int white = 255;
+		unsigned int black = 0;
+		for (unsigned int i = 0; i < SPOUT_TIMECODE_COLUMNS + SPOUT_TIMECODE_ROWS - 1; i++) {
+			const unsigned int row = (i < SPOUT_TIMECODE_COLUMNS) ? 0 : i - SPOUT_TIMECODE_COLUMNS + 1;
+			const unsigned int column = (i < SPOUT_TIMECODE_COLUMNS) ? i : 0;
+			const unsigned int value = level[row][column];
+			if (SpoutTimecodeCell(nullptr, row, column)) {
+				if (value < white) white = value;
+			}
+			else {
+				if (value > black) black = value;
+			}
+		}
+		if (white < black + 32)
+			continue;
+		const unsigned int threshold = (white + black)/2;
+
+		// Data bits
+		uint8_t bytes[SPOUT_TIMECODE_BYTES] = {};
+		for (unsigned int bit = 0; bit < SPOUT_TIMECODE_BYTES*8; bit++) {
+			const unsigned int row = 1 + bit/(SPOUT_TIMECODE_COLUMNS - 1);
+			const unsigned int column = 1 + bit%(SPOUT_TIMECODE_COLUMNS - 1);
+			if (level[row][column] > threshold)
+				bytes[bit/8] |= static_cast<uint8_t>(0x80 >> (bit%8));
+		}
+
+		const uint16_t crc = SpoutTimecodeCRC(bytes, 10);
+		if (bytes[10] != static_cast<uint8_t>(crc) || bytes[11] != static_cast<uint8_t>(crc >> 8))
+			continue;
+
+		frame = 0;
+		for (int i = 0; i < 4; i++)
+			frame |= static_cast<uint32_t>(bytes[i]) << (i*8);
+		time = 0;
+		for (int i = 0; i < 6; i++)
+			time |= static_cast<uint64_t>(bytes[4 + i]) << (i*8);
+		cell = size;
+		return true;
+	}
+
+	return false;
+}
+
+//
+// Microseconds from a capture time to a later time of the same base
+// Allows for the 48 bit capture time wrapping.
+//
+inline uint64_t SpoutTimecodeElapsed(uint64_t capture, uint64_t now)
+{
+	return (now - capture) & SPOUT_TIMECODE_TIMEMASK;
+}
+
+#endif
@@ -240,10 +240,34 @@
 		13.05.25 - Use a local file pointer for freopen_s with AllocConsole
 				   if "standaloneutils" is defined to avoid crash - unknown cause
 		25.05.25 - Add print option to EndTiming
+		19.10.26 - Add GetCounterMicroseconds for sender frame time stamps
+				 - Add EnableSpoutLogAsync, LogAsyncEnabled and FlushSpoutLog
+				   Logs are added to a bounded queue and written to console
+				   and file by a background thread. Queued logs are written
+				   at exit. Console and file output moved to _writeLog.
+				 - Add SetSpoutLogRateLimit. Logs are limited for each source
+				   (format string) with a token bucket for each log level.
+				   The number suppressed is logged with the next log allowed.
+				   _doLog - check log level and rate before formatting.
+				 - Add timing probes. SPOUT_TIMING, spoutTimer, EnableSpoutTiming,
+				   GetSpoutTimingProbe, AddSpoutTiming, GetSpoutTimingStats,
+				   DumpSpoutTiming and ResetSpoutTiming. Times are recorded for
+				   each thread and can be nested, unlike StartTiming/EndTiming.
+				 - EnableSpoutLogFile, DisableSpoutLogFile - hold the log write
+				   lock to close the file and change the path so that the log
+				   thread does not write to the file at the same time.
+				 - _rateLimitLog - atomic state for each log source instead
+				   of a lock. _doLog - compare a hash of the last log instead
+				   of copying each log to the shared log string.
+				 - Add _flushSuppressedLogs. Suppressed log counts not yet
+				   shown are logged each second with the next log from any
+				   source, by the log thread and by FlushSpoutLog.
 
 */
 
 #include "SpoutUtils.h"
+#include <atomic> // for asynchronous logging
+#include <mutex>
 
 //
 // Namespace: spoututils
@@ -272,12 +296,86 @@ namespace spoututils {
 	FILE* pCout = nullptr; // for log to console
 	std::ofstream logFile; // for log to file
 	std::string logPath; // folder path for the logfile
-	char logChars[1024]={}; // The current log string
+	char logChars[1024]={}; // Console and message text
+	std::atomic<uint64_t> logLastHash(0); // Hash of the last log, to prevent repeats
 	bool bConsole = false;
 #ifdef USE_CHRONO
 	std::chrono::steady_clock::time_point start;
 	std::chrono::steady_clock::time_point end;
 #endif
+	// Asynchronous logging
+	// A bounded multiple producer, single consumer queue of formatted logs.
+	// Each record has a sequence number that shows whether it is
+	// free for a producer or ready for the consumer.
+	// (Dmitry Vyukov bounded queue)
+	struct SpoutLogRecord {
+		std::atomic<size_t> sequence;
+		SpoutLogLevel level;
+		char text[1024];
+	};
+	const size_t logQueueSize = 256; // Must be a power of 2
+	SpoutLogRecord* logQueue = nullptr;
+	std::atomic<size_t> logEnqueuePos(0);
+	size_t logDequeuePos = 0; // Consumer only
+	std::atomic<bool> bLogAsync(false);
+	std::atomic<bool> bLogThread(false); // Thread is running
+	std::atomic<long> logDropped(0); // Discarded due to a full queue
+	SpoutLogOverflow logOverflow = SPOUT_LOG_OVERFLOW_DROP;
+	HANDLE hLogEvent = NULL; // Signals the thread for new logs
+	HANDLE hLogThread = NULL;
+	bool bLogExit = false; // Exit function registered
+	std::mutex logWriteLock; // Console and file output
+
+	// Log rate limits
+	// A token bucket for each log source, identified by the format string.
+	// The bucket is the time it will be full, so that it can be updated
+	// by any thread with one atomic exchange and without a lock.
+	// Each log moves the time on by one interval of the rate for the level.
+	struct SpoutLogRate {
+		std::atomic<const char*> format; // Log source, set once
+		std::atomic<double> full; // Time the bucket is full (microseconds)
+		std::atomic<long> suppressed; // Logs suppressed since the last
+		std::atomic<int> level; // Level of the last log suppressed
+	};
+	const int logRateSize = 128; // Log sources recorded
+	SpoutLogRate logRates[logRateSize]; // Zero initialized
+	// Suppressed counts not yet shown are logged each second
+	const ULONGLONG logFlushInterval = 1000; // msec
+	std::atomic<ULONGLONG> logFlushTime(0); // Time of the last
+	// Logs per second and burst for each log level (0 - no limit)
+	std::atomic<double> logRatePerSecond[SPOUT_LOG_NONE + 1] = { {0.0}, {10.0}, {10.0}, {10.0}, {10.0}, {0.0}, {0.0} };
+	std::atomic<double> logRateBurst[SPOUT_LOG_NONE + 1]     = { {0.0}, {20.0}, {20.0}, {20.0}, {20.0}, {0.0}, {0.0} };
+
+	// Timing probes
+	// Histogram bins for percentiles. Eight bins for each doubling
+	// of time from 1 microsecond, so a percentile is within 9%.
+	const int timingBins = 200; // to 2^25 microseconds (33 seconds)
+	struct SpoutTimingSlot {
+		std::atomic<long long> count;
+		std::atomic<double> sum;
+		std::atomic<double> min;
+		std::atomic<double> max;
+		std::atomic<unsigned int> bins[timingBins];
+	};
+	// Storage for each thread that records times.
+	// Only the owning thread writes to it, so atomic
+	// loads and stores are sufficient without locks.
+	// Storage remains after a thread exits so that
+	// the times recorded are still included.
+	struct SpoutTimingThread {
+		std::atomic<SpoutTimingSlot*> slots[SPOUT_TIMING_PROBES];
+		std::atomic<long> epoch; // reset count when last recorded
+		SpoutTimingThread* next;
+	};
+	std::atomic<bool> bTimingEnabled(false);
+	std::atomic<int> timingProbeCount(0);
+	char timingNames[SPOUT_TIMING_PROBES][SPOUT_TIMING_NAME]={};
+	std::mutex timingLock; // For probe registration
+	std::atomic<SpoutTimingThread*> timingThreads(nullptr); // List of thread storage
+	std::atomic<long> timingEpoch(0); // Incremented by ResetSpoutTiming
+	double timingFrequency = 0.0; // Performance counter ticks per microsecond
+	thread_local SpoutTimingThread* pTimingThread = nullptr;
+
 	// PC timer
 	double PCFreq = 0.0;
 	__int64 CounterStart = 0;
@@ -632,8 +730,8 @@ namespace spoututils {
 		bConsole = true;
 		bEnableLog = true;
 
-		// Initialize current log string
-		logChars[0] = 0;
+		// Initialize the last log
+		logLastHash = 0;
 	}
 
 	// ---------------------------------------------------------
@@ -658,13 +756,18 @@ namespace spoututils {
 	// You can find and examine the log file after the application has run.
 	void EnableSpoutLogFile(const char* filename, bool bAppend)
 	{
+		FlushSpoutLog();
+
+		// The log thread writes to the file with the same lock
+		std::lock_guard<std::mutex> lock(logWriteLock);
+
 		bEnableLogFile = true;
 		if (!logPath.empty()) {
 			if (logFile.is_open())
 				logFile.close();
 			logPath.clear();
 		}
-		logChars[0] = 0;
+		logLastHash = 0;
 
 		// Create the log file path given the filename passed in
 		logPath = _getLogFilePath(filename);
@@ -677,6 +780,8 @@ namespace spoututils {
 	// Function: DisableSpoutLogFile
 	// Disable logging to file
 	void DisableSpoutLogFile() {
+		FlushSpoutLog();
+		std::lock_guard<std::mutex> lock(logWriteLock);
 		if (!logPath.empty()) {
 			if (logFile.is_open())
 				logFile.close();
@@ -710,6 +815,7 @@ namespace spoututils {
 	// Disable logging to console and file
 	void DisableSpoutLog()
 	{
+		EnableSpoutLogAsync(false);
 		CloseSpoutConsole();
 		if (!logPath.empty()) {
 			if (logFile.is_open())
@@ -833,6 +939,142 @@ namespace spoututils {
 	}
 
 
+	// ---------------------------------------------------------
+	// Function: EnableSpoutLogAsync
+	// Enable or disable asynchronous logging
+	//
+	// Console and file output is done by a background thread so that
+	// logging does not delay the calling thread. For example, a log
+	// written for every frame by a video thread.
+	//
+	// The calling thread formats the log and adds it to a queue of
+	// 256 logs without locking. If the queue is full, the overflow
+	// option applies :
+	//
+	//    SPOUT_LOG_OVERFLOW_DROP - discard the log (default).
+	//        The number discarded is logged when there is space.
+	//    SPOUT_LOG_OVERFLOW_WAIT - wait until there is space.
+	//    SPOUT_LOG_OVERFLOW_SYNC - write the log on the calling thread.
+	//
+	// Queued logs are written when asynchronous logging is disabled,
+	// by FlushSpoutLog, and at exit.
+	//
+	// While the thread is running, it holds a reference to the module
+	// so that a dll is not unloaded with the thread active.
+	//
+	//     Example : EnableSpoutLogAsync();
+	//
+	void EnableSpoutLogAsync(bool bAsync, SpoutLogOverflow overflow)
+	{
+		logOverflow = overflow;
+
+		if (bAsync) {
+			if (bLogAsync)
+				return;
+
+			if (!logQueue) {
+				logQueue = new SpoutLogRecord[logQueueSize];
+				for (size_t i = 0; i < logQueueSize; i++)
+					logQueue[i].sequence.store(i, std::memory_order_relaxed);
+				logEnqueuePos.store(0);
+				logDequeuePos = 0;
+			}
+
+			if (!hLogEvent)
+				hLogEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+			// Reference this module for the thread
+			HMODULE hModule = NULL;
+			GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+				reinterpret_cast<LPCSTR>(&_logThread), &hModule);
+
+			bLogThread = true;
+			hLogThread = CreateThread(NULL, 0, _logThread, hModule, 0, NULL);
+			if (!hLogThread) {
+				bLogThread = false;
+				if (hModule) FreeLibrary(hModule);
+				return;
+			}
+
+			// Write queued logs at exit
+			if (!bLogExit) {
+				atexit(_exitLog);
+				bLogExit = true;
+			}
+
+			bLogAsync = true;
+		}
+		else {
+			if (!bLogAsync)
+				return;
+
+			// Stop the thread. It writes any logs remaining.
+			bLogAsync = false;
+			bLogThread = false;
+			SetEvent(hLogEvent);
+			if (hLogThread) {
+				WaitForSingleObject(hLogThread, 1000);
+				CloseHandle(hLogThread);
+				hLogThread = NULL;
+			}
+			// Any logs added meanwhile
+			_writeLogQueue();
+		}
+	}
+
+	// ---------------------------------------------------------
+	// Function: SetSpoutLogRateLimit
+	// Limit the rate of logs from the same source for a log level
+	//
+	// A log that is repeated continuously, for example an error for
+	// every frame, can make logging the greatest cost for the frame.
+	//
+	// Logs from the same source (the same format string) are limited
+	// to "rate" per second, with a "burst" of up to that number at once.
+	// Logs in excess of the limit are not formatted or written, and the
+	// number suppressed is shown with the next log from that source.
+	// If there is none, the number is shown within a second with the next
+	// log from any source or by the asynchronous log thread, and at once
+	// by FlushSpoutLog.
+	//
+	// The default is 10 per second with a burst of 20 for all levels
+	// except fatal errors and general logs (SpoutLog), which are not limited.
+	// A rate of zero removes the limit for the level.
+	//
+	//     Example : SetSpoutLogRateLimit(SPOUT_LOG_WARNING, 1.0, 5.0);
+	//
+	void SetSpoutLogRateLimit(SpoutLogLevel level, double rate, double burst)
+	{
+		if (level < SPOUT_LOG_SILENT || level > SPOUT_LOG_NONE)
+			return;
+		if (rate < 0.0) rate = 0.0;
+		if (burst < 1.0) burst = (rate > 1.0) ? rate : 1.0;
+		logRatePerSecond[level] = rate;
+		logRateBurst[level] = burst;
+	}
+
+	// ---------------------------------------------------------
+	// Function: LogAsyncEnabled
+	// Is asynchronous logging enabled
+	bool LogAsyncEnabled()
+	{
+		return bLogAsync;
+	}
+
+	// ---------------------------------------------------------
+	// Function: FlushSpoutLog
+	// Write all queued logs before returning
+	//
+	// Used before the log file is changed or the application
+	// closes a console. The number of rate limited logs suppressed
+	// and not yet shown is logged first (see SetSpoutLogRateLimit).
+	void FlushSpoutLog()
+	{
+		_flushSuppressedLogs(true, false);
+		if (logQueue)
+			_writeLogQueue();
+	}
+
 	// ---------------------------------------------------------
 	// Function: SpoutLog
 	// General purpose log - ignore log levels and no log level shown
@@ -914,67 +1156,41 @@ namespace spoututils {
 		if (!format)
 			return;
 
-		char currentLog[1024]={}; // allow more than the name length
-
-		// Construct the current log
-		vsprintf_s(currentLog, 1024, format, args);
-
 		// Return if logging is paused
 		if (!bDoLogs)
 			return;
 
+		// Suppressed counts of other sources
+		_flushSuppressedLogs(false, false);
+
 		if (level != SPOUT_LOG_SILENT
 			&& CurrentLogLevel != SPOUT_LOG_SILENT
-			&& level >= CurrentLogLevel
-			&& format != nullptr) {
+			&& level >= CurrentLogLevel) {
 
-			// Prevent multiple logs by comparing with the last
-			if (strcmp(currentLog, logChars) == 0) {
-				// Save the current log as the last
-				strcpy_s(logChars, 1024, currentLog);
+			// Return if logs from this source exceed the rate limit
+			long suppressed = 0;
+			if (!_rateLimitLog(level, format, suppressed))
 				return;
-			}
 
-			// Save the current log as the last
-			strcpy_s(logChars, 1024, currentLog);
+			char currentLog[1024]={}; // allow more than the name length
 
-			// Console logging
-			if (bConsole && bEnableLog) {
-				// Yellow text for warnings and errors
-				HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-				FILE* out = stdout; // Console output
-				if (level == SPOUT_LOG_WARNING || level == SPOUT_LOG_ERROR)
-					SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-				if (level != SPOUT_LOG_NONE) {
-					// Show log level
-					fprintf(out, "[%s] ", _levelName(level).c_str());
-				}
-				// The log
-				vfprintf(out, format, args);
-				// Newline
-				fprintf(out, "\n");
-				// Reset white text
-				SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-			} // end console log
+			// Construct the current log
+			vsprintf_s(currentLog, 1024, format, args);
 
-			// File logging
-			if (bEnableLogFile && !logPath.empty()) {
-				// Log file output
-				// Append to the the current log file so it remains closed
-				// No verbose logs for log to file
-				if (level != SPOUT_LOG_VERBOSE) {
-					logFile.open(logPath, logFile.app);
-					if (logFile.is_open()) {
-						if (level != SPOUT_LOG_NONE) {
-							// Show log level
-							logFile << "[" << _levelName(level).c_str()  << "] ";
-						}
-						// The log and newline
-						logFile << currentLog << std::endl;
-					}
-					logFile.close();
-				}
-			} // end file log
+			// Prevent multiple logs by comparing with the last
+			// and save the current log as the last
+			const uint64_t hash = _hashLog(currentLog);
+			const bool bRepeat = (logLastHash.exchange(hash) == hash);
+
+			if (!bRepeat)
+				_outputLog(level, currentLog);
+
+			// Summary of logs suppressed since the last
+			if (suppressed > 0) {
+				char summary[128]={};
+				sprintf_s(summary, 128, "    (%ld similar logs suppressed)", suppressed);
+				_outputLog(level, summary);
+			}
 		}
 	}
 
@@ -1664,6 +1880,269 @@ namespace spoututils {
 		}
 	}
 
+	// -----------------------------------------------
+	// Function: GetCounterMicroseconds
+	// Microseconds from the system performance counter.
+	//
+	// Unlike GetCounter, this is not relative to a start time.
+	// The performance counter is consistent between processes
+	// so that a receiver can compare a sender frame time stamp
+	// with the time it was received.
+	double GetCounterMicroseconds()
+	{
+		LARGE_INTEGER freq;
+		LARGE_INTEGER count;
+		if (QueryPerformanceFrequency(&freq) && QueryPerformanceCounter(&count) && freq.QuadPart > 0) {
+			// Whole seconds and remainder separately to avoid overflow
+			const __int64 seconds = count.QuadPart / freq.QuadPart;
+			const __int64 remainder = count.QuadPart % freq.QuadPart;
+			return static_cast<double>(seconds)*1000000.0
+				+ static_cast<double>(remainder*1000000 / freq.QuadPart);
+		}
+		return 0.0;
+	}
+
+	//
+	// Group: Timing probes
+	//
+	// StartTiming/EndTiming and StartCounter/GetCounter share a single
+	// start time and cannot be nested or used by more than one thread.
+	//
+	// Timing probes are named and record times for each thread separately.
+	// Each probe keeps the count, minimum, mean and maximum time and a
+	// histogram for percentiles. A probe is created once for each name
+	// and any thread can record times for it.
+	//
+	// The simplest use is to time the rest of a scope :
+	//
+	//     SPOUT_TIMING("ReceiveImage");
+	//
+	// Times are recorded only if enabled by EnableSpoutTiming.
+	// Otherwise the cost is a flag test. Results are shown in the
+	// Spout log by DumpSpoutTiming or retrieved by GetSpoutTimingStats.
+	//
+
+	// ---------------------------------------------------------
+	// Function: EnableSpoutTiming
+	// Enable or disable timing probes
+	void EnableSpoutTiming(bool bEnable)
+	{
+		if (bEnable && timingFrequency <= 0.0) {
+			LARGE_INTEGER li={};
+			if (!QueryPerformanceFrequency(&li))
+				return;
+			timingFrequency = static_cast<double>(li.QuadPart)/1000000.0;
+		}
+		bTimingEnabled = bEnable;
+	}
+
+	// ---------------------------------------------------------
+	// Function: SpoutTimingEnabled
+	// Are timing probes enabled
+	bool SpoutTimingEnabled()
+	{
+		return bTimingEnabled;
+	}
+
+	// ---------------------------------------------------------
+	// Function: GetSpoutTimingProbe
+	// Find or create a named probe and return its index.
+	// Returns -1 if the maximum number of probes has been reached.
+	int GetSpoutTimingProbe(const char* name)
+	{
+		if (!name || !*name)
+			return -1;
+
+		std::lock_guard<std::mutex> lock(timingLock);
+		const int count = timingProbeCount;
+		for (int i = 0; i < count; i++) {
+			if (strcmp(timingNames[i], name) == 0)
+				return i;
+		}
+		if (count >= SPOUT_TIMING_PROBES)
+			return -1;
+
+		strncpy_s(timingNames[count], SPOUT_TIMING_NAME, name, _TRUNCATE);
+		timingProbeCount = count + 1;
+		return count;
+	}
+
+	// ---------------------------------------------------------
+	// Function: GetSpoutTimingCount
+	// Number of probes
+	int GetSpoutTimingCount()
+	{
+		return timingProbeCount;
+	}
+
+	// ---------------------------------------------------------
+	// Function: AddSpoutTiming
+	// Record a time for a probe (microseconds)
+	void AddSpoutTiming(int probe, double microseconds)
+	{
+		if (!bTimingEnabled || probe < 0 || probe >= timingProbeCount)
+			return;
+
+		SpoutTimingThread* pThread = _timingThread();
+		if (!pThread)
+			return;
+
+		// Clear times recorded before the last reset
+		const long epoch = timingEpoch.load(std::memory_order_acquire);
+		if (pThread->epoch.load(std::memory_order_relaxed) != epoch) {
+			for (int i = 0; i < SPOUT_TIMING_PROBES; i++) {
+				SpoutTimingSlot* pSlot = pThread->slots[i].load(std::memory_order_relaxed);
+				if (pSlot) {
+					pSlot->count.store(0, std::memory_order_relaxed);
+					pSlot->sum.store(0.0, std::memory_order_relaxed);
+					for (int j = 0; j < timingBins; j++)
+						pSlot->bins[j].store(0, std::memory_order_relaxed);
+				}
+			}
+			pThread->epoch.store(epoch, std::memory_order_release);
+		}
+
+		SpoutTimingSlot* pSlot = pThread->slots[probe].load(std::memory_order_relaxed);
+		if (!pSlot) {
+			pSlot = new SpoutTimingSlot();
+			pThread->slots[probe].store(pSlot, std::memory_order_release);
+		}
+
+		// Bin 0 is up to 1 microsecond, then 8 bins for each doubling
+		int bin = 0;
+		if (microseconds > 1.0)
+			bin = static_cast<int>(8.0*log2(microseconds)) + 1;
+		if (bin >= timingBins)
+			bin = timingBins - 1;
+
+		const long long count = pSlot->count.load(std::memory_order_relaxed);
+		if (count == 0 || microseconds < pSlot->min.load(std::memory_order_relaxed))
+			pSlot->min.store(microseconds, std::memory_order_relaxed);
+		if (count == 0 || microseconds > pSlot->max.load(std::memory_order_relaxed))
+			pSlot->max.store(microseconds, std::memory_order_relaxed);
+		pSlot->sum.store(pSlot->sum.load(std::memory_order_relaxed) + microseconds, std::memory_order_relaxed);
+		pSlot->bins[bin].store(pSlot->bins[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		// The count is stored last for other threads reading the times
+		pSlot->count.store(count + 1, std::memory_order_release);
+	}
+
+	// ---------------------------------------------------------
+	// Function: GetSpoutTimingStats
+	// Statistics for a probe combined from all threads.
+	// Returns false if no times have been recorded.
+	// Times recorded while reading might be partly included.
+	bool GetSpoutTimingStats(int probe, SpoutTimingStats &stats)
+	{
+		stats = {};
+		if (probe < 0 || probe >= timingProbeCount)
+			return false;
+
+		strcpy_s(stats.name, SPOUT_TIMING_NAME, timingNames[probe]);
+
+		unsigned long long bins[timingBins]={};
+		double sum = 0.0;
+		const long epoch = timingEpoch.load(std::memory_order_acquire);
+		for (SpoutTimingThread* pThread = timingThreads.load(std::memory_order_acquire); pThread; pThread = pThread->next) {
+			if (pThread->epoch.load(std::memory_order_acquire) != epoch)
+				continue;
+			SpoutTimingSlot* pSlot = pThread->slots[probe].load(std::memory_order_acquire);
+			if (!pSlot)
+				continue;
+			const long long count = pSlot->count.load(std::memory_order_acquire);
+			if (count == 0)
+				continue;
+			const double slotmin = pSlot->min.load(std::memory_order_relaxed);
+			const double slotmax = pSlot->max.load(std::memory_order_relaxed);
+			if (stats.count == 0 || slotmin < stats.min) stats.min = slotmin;
+			if (stats.count == 0 || slotmax > stats.max) stats.max = slotmax;
+			stats.count += count;
+			sum += pSlot->sum.load(std::memory_order_relaxed);
+			for (int i = 0; i < timingBins; i++)
+				bins[i] += pSlot->bins[i].load(std::memory_order_relaxed);
+		}
+
+		if (stats.count == 0)
+			return false;
+
+		stats.mean = sum/static_cast<double>(stats.count);
+
+		// Percentiles from the upper limit of the histogram bin,
+		// within the range recorded
+		unsigned long long total = 0;
+		for (int i = 0; i < timingBins; i++)
+			total += bins[i];
+		const double percent[3] = { 0.50, 0.95, 0.99 };
+		double* result[3] = { &stats.p50, &stats.p95, &stats.p99 };
+		for (int p = 0; p < 3; p++) {
+			const unsigned long long target = static_cast<unsigned long long>(ceil(percent[p]*static_cast<double>(total)));
+			unsigned long long cumulative = 0;
+			int bin = 0;
+			for (bin = 0; bin < timingBins - 1; bin++) {
+				cumulative += bins[bin];
+				if (cumulative >= target)
+					break;
+			}
+			double value = pow(2.0, static_cast<double>(bin)/8.0);
+			if (value < stats.min) value = stats.min;
+			if (value > stats.max) value = stats.max;
+			*result[p] = value;
+		}
+
+		return true;
+	}
+
+	// ---------------------------------------------------------
+	// Function: DumpSpoutTiming
+	// Log statistics for all probes with optional reset
+	void DumpSpoutTiming(bool bReset)
+	{
+		SpoutLog("Timing (microseconds)        count        min       mean        p50        p95        p99        max");
+		SpoutTimingStats stats={};
+		const int count = timingProbeCount;
+		for (int i = 0; i < count; i++) {
+			if (GetSpoutTimingStats(i, stats)) {
+				SpoutLog("%-24.24s %10lld %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f",
+					stats.name, stats.count, stats.min, stats.mean,
+					stats.p50, stats.p95, stats.p99, stats.max);
+			}
+		}
+		if (bReset)
+			ResetSpoutTiming();
+	}
+
+	// ---------------------------------------------------------
+	// Function: ResetSpoutTiming
+	// Clear all recorded times.
+	// Each thread clears its own times when it next records.
+	void ResetSpoutTiming()
+	{
+		timingEpoch++;
+	}
+
+	// ---------------------------------------------------------
+	// Class: spoutTimer
+	// Record the time from construction to destruction for a probe.
+	// Usually created with the SPOUT_TIMING macro.
+	spoutTimer::spoutTimer(int probe)
+	{
+		m_probe = probe;
+		m_start = 0;
+		if (bTimingEnabled && probe >= 0) {
+			LARGE_INTEGER li={};
+			QueryPerformanceCounter(&li);
+			m_start = li.QuadPart;
+		}
+	}
+
+	spoutTimer::~spoutTimer()
+	{
+		if (m_start > 0) {
+			LARGE_INTEGER li={};
+			QueryPerformanceCounter(&li);
+			AddSpoutTiming(m_probe, static_cast<double>(li.QuadPart - m_start)/timingFrequency);
+		}
+	}
+
 	//
 	// Private functions
 	//
@@ -1841,6 +2320,297 @@ namespace spoututils {
 			return "SpoutLog.log";
 		}
 
+		// Console and file output for a log
+		// The log file is opened if necessary and closed by the caller
+		// so that more than one log can be written.
+		void _writeLog(SpoutLogLevel level, const char* text)
+		{
+			// Console logging
+			if (bConsole && bEnableLog) {
+				// Yellow text for warnings and errors
+				HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+				FILE* out = stdout; // Console output
+				if (level == SPOUT_LOG_WARNING || level == SPOUT_LOG_ERROR)
+					SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY);
+				if (level != SPOUT_LOG_NONE) {
+					// Show log level
+					fprintf(out, "[%s] ", _levelName(level).c_str());
+				}
+				// The log and newline
+				fprintf(out, "%s\n", text);
+				// Reset white text
+				SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
+			} // end console log
+
+			// File logging
+			if (bEnableLogFile && !logPath.empty()) {
+				// Log file output
+				// No verbose logs for log to file
+				if (level != SPOUT_LOG_VERBOSE) {
+					if (!logFile.is_open())
+						logFile.open(logPath, logFile.app);
+					if (logFile.is_open()) {
+						if (level != SPOUT_LOG_NONE) {
+							// Show log level
+							logFile << "[" << _levelName(level).c_str()  << "] ";
+						}
+						// The log and newline
+						logFile << text << "\n";
+					}
+				}
+			} // end file log
+		}
+
+		// Output a formatted log to the queue or directly
+		void _outputLog(SpoutLogLevel level, const char* text)
+		{
+			// Asynchronous logging
+			// Add the log to the queue for the log thread
+			if (bLogAsync) {
+				if (_pushLog(level, text)) {
+					SetEvent(hLogEvent);
+					return;
+				}
+				// The queue is full
+				if (logOverflow == SPOUT_LOG_OVERFLOW_WAIT) {
+					while (bLogThread && !_pushLog(level, text)) {
+						SetEvent(hLogEvent);
+						Sleep(1);
+					}
+					if (bLogThread)	return;
+				}
+				else if (logOverflow == SPOUT_LOG_OVERFLOW_DROP) {
+					logDropped++;
+					return;
+				}
+				// SPOUT_LOG_OVERFLOW_SYNC - write the log now
+			}
+
+			std::lock_guard<std::mutex> lock(logWriteLock);
+			_writeLog(level, text);
+			// Append to the the current log file so it remains closed
+			if (logFile.is_open())
+				logFile.close();
+		}
+
+		// Token bucket rate limit for a log source
+		// Returns false if the log should be suppressed.
+		// Returns the number suppressed since the last log allowed.
+		bool _rateLimitLog(SpoutLogLevel level, const char* format, long &suppressed)
+		{
+			suppressed = 0;
+			if (level < SPOUT_LOG_SILENT || level > SPOUT_LOG_NONE)
+				return true;
+
+			const double rate = logRatePerSecond[level].load(std::memory_order_relaxed);
+			if (rate <= 0.0)
+				return true;
+			const double burst = logRateBurst[level].load(std::memory_order_relaxed);
+
+			// Find the source or claim a free entry
+			const uintptr_t hash = (reinterpret_cast<uintptr_t>(format) >> 3) * 2654435761u;
+			SpoutLogRate* entry = nullptr;
+			for (int i = 0; i < logRateSize; i++) {
+				SpoutLogRate* item = &logRates[(hash + i) % logRateSize];
+				const char* source = nullptr;
+				if (item->format.compare_exchange_strong(source, format) || source == format) {
+					entry = item;
+					break;
+				}
+			}
+			// No limit if the table is full
+			if (!entry)
+				return true;
+
+			// A new entry is full at time zero and allows a burst at once.
+			// The log is suppressed if the bucket would be full more than
+			// the burst of intervals from now.
+			const double interval = 1000000.0/rate;
+			const double now = GetCounterMicroseconds();
+			double full = entry->full.load(std::memory_order_relaxed);
+			for (;;) {
+				const double start = (full > now) ? full : now;
+				if (start + interval - now > burst*interval) {
+					entry->level.store(level, std::memory_order_relaxed);
+					entry->suppressed.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				if (entry->full.compare_exchange_weak(full, start + interval, std::memory_order_relaxed))
+					break;
+			}
+
+			suppressed = entry->suppressed.exchange(0, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Log the number suppressed for sources that have not logged since.
+		// Once for each interval unless forced. Only the thread that
+		// updates the time checks the sources.
+		// The log thread writes directly rather than wait for itself
+		// if the queue is full.
+		void _flushSuppressedLogs(bool bForce, bool bDirect)
+		{
+			const ULONGLONG now = GetTickCount64();
+			ULONGLONG last = logFlushTime.load(std::memory_order_relaxed);
+			if (!bForce && now - last < logFlushInterval)
+				return;
+			if (!logFlushTime.compare_exchange_strong(last, now) && !bForce)
+				return;
+
+			for (int i = 0; i < logRateSize; i++) {
+				SpoutLogRate* entry = &logRates[i];
+				const char* format = entry->format.load(std::memory_order_acquire);
+				if (!format || entry->suppressed.load(std::memory_order_relaxed) == 0)
+					continue;
+				const long suppressed = entry->suppressed.exchange(0, std::memory_order_relaxed);
+				if (suppressed > 0) {
+					char summary[256]={};
+					sprintf_s(summary, 256, "    (%ld similar logs suppressed : %.180s)", suppressed, format);
+					const SpoutLogLevel level = static_cast<SpoutLogLevel>(entry->level.load(std::memory_order_relaxed));
+					if (bDirect) {
+						std::lock_guard<std::mutex> lock(logWriteLock);
+						_writeLog(level, summary);
+						if (logFile.is_open())
+							logFile.close();
+					}
+					else {
+						_outputLog(level, summary);
+					}
+				}
+			}
+		}
+
+		// Hash of a log to compare with the last (FNV-1a)
+		uint64_t _hashLog(const char* text)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for (const char* c = text; *c; c++) {
+				hash ^= static_cast<unsigned char>(*c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		// Add a log to the queue
+		// Returns false if the queue is full
+		bool _pushLog(SpoutLogLevel level, const char* text)
+		{
+			if (!logQueue)
+				return false;
+
+			size_t pos = logEnqueuePos.load(std::memory_order_relaxed);
+			for (;;) {
+				SpoutLogRecord* record = &logQueue[pos & (logQueueSize - 1)];
+				const size_t seq = record->sequence.load(std::memory_order_acquire);
+				const intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (dif == 0) {
+					// The record is free. Claim it.
+					if (logEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						record->level = level;
+						strcpy_s(record->text, 1024, text);
+						// Ready for the consumer
+						record->sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (dif < 0) {
+					// The queue is full
+					return false;
+				}
+				else {
+					// Another producer claimed it
+					pos = logEnqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// Write all logs in the queue
+		// The log file is opened once for all logs
+		void _writeLogQueue()
+		{
+			std::lock_guard<std::mutex> lock(logWriteLock);
+
+			if (!logQueue)
+				return;
+
+			for (;;) {
+				SpoutLogRecord* record = &logQueue[logDequeuePos & (logQueueSize - 1)];
+				const size_t seq = record->sequence.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(logDequeuePos + 1) < 0)
+					break; // empty
+				_writeLog(record->level, record->text);
+				// Free for a producer
+				record->sequence.store(logDequeuePos + logQueueSize, std::memory_order_release);
+				logDequeuePos++;
+			}
+
+			const long dropped = logDropped.exchange(0);
+			if (dropped > 0) {
+				char text[128]={};
+				sprintf_s(text, 128, "%ld logs discarded (log queue full)", dropped);
+				_writeLog(SPOUT_LOG_WARNING, text);
+			}
+
+			if (logFile.is_open())
+				logFile.close();
+		}
+
+		// Asynchronous log thread
+		// The module reference is released when the thread exits.
+		DWORD WINAPI _logThread(LPVOID lpParam)
+		{
+			HMODULE hModule = static_cast<HMODULE>(lpParam);
+			while (bLogThread) {
+				WaitForSingleObject(hLogEvent, 100);
+				_writeLogQueue();
+				_flushSuppressedLogs(false, true);
+			}
+			_writeLogQueue();
+			if (hModule)
+				FreeLibraryAndExitThread(hModule, 0);
+			return 0;
+		}
+
+		// Timing probe storage for the calling thread
+		// Created on first use and added to the list for all threads
+		SpoutTimingThread* _timingThread()
+		{
+			if (pTimingThread)
+				return pTimingThread;
+
+			SpoutTimingThread* pThread = new SpoutTimingThread();
+			for (int i = 0; i < SPOUT_TIMING_PROBES; i++)
+				pThread->slots[i].store(nullptr, std::memory_order_relaxed);
+			pThread->epoch.store(timingEpoch.load(), std::memory_order_relaxed);
+
+			// Add to the start of the list without locking
+			SpoutTimingThread* pHead = timingThreads.load(std::memory_order_relaxed);
+			do {
+				pThread->next = pHead;
+			} while (!timingThreads.compare_exchange_weak(pHead, pThread,
+				std::memory_order_release, std::memory_order_relaxed));
+
+			pTimingThread = pThread;
+			return pThread;
+		}
+
+		// Write queued logs at exit.
+		// At process exit the log thread has already ended
+		// so the logs are written on the calling thread.
+		// The thread might have stopped while writing and
+		// left the lock held, so do not wait for it.
+		void _exitLog()
+		{
+			bLogThread = false;
+			bLogAsync = false;
+			if (!logQueue)
+				return;
+			if (logWriteLock.try_lock()) {
+				logWriteLock.unlock();
+				_writeLogQueue();
+			}
+		}
+
 		// Get the name for the current log level
 		std::string _levelName(SpoutLogLevel level) {
 
@@ -93,6 +93,18 @@ name='Microsoft.Windows.Common-Controls' version='6.0.0.0' \
 processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
 #endif
 
+// Timing probes
+#define SPOUT_TIMING_PROBES 64 // Maximum number of probes
+#define SPOUT_TIMING_NAME 64 // Maximum probe name length
+
+// Time the enclosing scope with a named probe
+//     Example : SPOUT_TIMING("ReceiveImage");
+#define SPOUT_TIMING_CAT2(a, b) a##b
+#define SPOUT_TIMING_CAT(a, b) SPOUT_TIMING_CAT2(a, b)
+#define SPOUT_TIMING(name) \
+	static const int SPOUT_TIMING_CAT(spoutProbe, __LINE__) = spoututils::GetSpoutTimingProbe(name); \
+	spoututils::spoutTimer SPOUT_TIMING_CAT(spoutTimer, __LINE__)(SPOUT_TIMING_CAT(spoutProbe, __LINE__))
+
 // SpoutUtils
 namespace spoututils {
 
@@ -113,6 +125,16 @@ namespace spoututils {
 		SPOUT_LOG_NONE
 	};
 
+	// Asynchronous logging when the log queue is full
+	enum SpoutLogOverflow {
+		// Discard the log and report the number discarded - default
+		SPOUT_LOG_OVERFLOW_DROP,
+		// Wait for space in the queue. Logs are not lost but the caller is delayed.
+		SPOUT_LOG_OVERFLOW_WAIT,
+		// Write the log on the calling thread as for synchronous logging
+		SPOUT_LOG_OVERFLOW_SYNC
+	};
+
 	//
 	// Information
 	//
@@ -229,6 +251,20 @@ namespace spoututils {
 	// Fatal - always show log
 	void SPOUT_DLLEXP SpoutLogFatal(const char* format, ...);
 
+	// Write logs to console and file with a background thread.
+	// The calling thread only formats the log and adds it to a queue.
+	void SPOUT_DLLEXP EnableSpoutLogAsync(bool bAsync = true, SpoutLogOverflow overflow = SPOUT_LOG_OVERFLOW_DROP);
+
+	// Is asynchronous logging enabled
+	bool SPOUT_DLLEXP LogAsyncEnabled();
+
+	// Write all queued logs before returning
+	void SPOUT_DLLEXP FlushSpoutLog();
+
+	// Limit the rate of logs from the same source for a log level
+	// Rate is logs per second (0 - no limit). Burst is the most at once.
+	void SPOUT_DLLEXP SetSpoutLogRateLimit(SpoutLogLevel level, double rate, double burst = 0.0);
+
 	// Logging function.
 	void SPOUT_DLLEXP _doLog(SpoutLogLevel level, const char* format, va_list args);
 
@@ -352,6 +388,60 @@ namespace spoututils {
 
 	void SPOUT_DLLEXP StartCounter();
 	double SPOUT_DLLEXP GetCounter();
+	// Microseconds from the system performance counter.
+	// Consistent between processes for frame time stamps.
+	double SPOUT_DLLEXP GetCounterMicroseconds();
+
+	//
+	// Timing probes
+	//
+	// Named probes record elapsed times from any thread.
+	// Each thread records to its own storage without locking
+	// and the results are combined when statistics are requested.
+	// Recording is disabled by default and then costs only a flag test.
+	//
+
+	// Statistics for a timing probe (microseconds)
+	struct SpoutTimingStats {
+		char name[SPOUT_TIMING_NAME];
+		long long count;
+		double min;
+		double mean;
+		double max;
+		double p50;
+		double p95;
+		double p99;
+	};
+
+	// Enable or disable timing probes
+	void SPOUT_DLLEXP EnableSpoutTiming(bool bEnable = true);
+	// Are timing probes enabled
+	bool SPOUT_DLLEXP SpoutTimingEnabled();
+	// Find or create a named probe and return its index (-1 if none available)
+	int SPOUT_DLLEXP GetSpoutTimingProbe(const char* name);
+	// Number of probes
+	int SPOUT_DLLEXP GetSpoutTimingCount();
+	// Record a time for a probe (microseconds)
+	void SPOUT_DLLEXP AddSpoutTiming(int probe, double microseconds);
+	// Statistics for a probe from all threads
+	bool SPOUT_DLLEXP GetSpoutTimingStats(int probe, SpoutTimingStats &stats);
+	// Log statistics for all probes with optional reset
+	void SPOUT_DLLEXP DumpSpoutTiming(bool bReset = false);
+	// Clear all recorded times
+	void SPOUT_DLLEXP ResetSpoutTiming();
+
+	// Timing probe storage for each thread
+	struct SpoutTimingThread;
+
+	// Record the time from construction to destruction for a probe
+	class SPOUT_DLLEXP spoutTimer {
+	public:
+		spoutTimer(int probe);
+		~spoutTimer();
+	private:
+		int m_probe;
+		LONGLONG m_start;
+	};
 
 	//
 	// Private functions
@@ -363,6 +453,23 @@ namespace spoututils {
 		std::string _getLogPath();
 		std::string _getLogFilePath(const char *filename);
 		std::string _levelName(SpoutLogLevel level);
+		// Console and file output for a log
+		void _writeLog(SpoutLogLevel level, const char* text);
+		// Output a formatted log to the queue or directly
+		void _outputLog(SpoutLogLevel level, const char* text);
+		// Log rate limit for a log source
+		bool _rateLimitLog(SpoutLogLevel level, const char* format, long &suppressed);
+		// Log suppressed counts not yet shown
+		void _flushSuppressedLogs(bool bForce, bool bDirect);
+		// Hash of a log to compare with the last
+		uint64_t _hashLog(const char* text);
+		// Asynchronous log queue
+		bool _pushLog(SpoutLogLevel level, const char* text);
+		void _writeLogQueue();
+		DWORD WINAPI _logThread(LPVOID lpParam);
+		void _exitLog();
+		// Timing probe storage for the calling thread
+		SpoutTimingThread* _timingThread();
 		// Taskdialog for SpoutMessageBox
 		int MessageTaskDialog(HWND hWnd, const char* content, const char* caption, DWORD dwButtons, DWORD dwMilliseconds);
 		// TaskDialogIndirect callback to handle timer, topmost and hyperlinks
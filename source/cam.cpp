@@ -325,6 +325,64 @@
 			   No code changes for SpoutCam
 	23.07.25   Update ReceiveImage for multiple formats with DirectX 11 compute shaders
 	20.10.25   Update Version.h - Vers 2.035 (Spout 2.007.017)
+	19.10.26   Add "framewait" registry option. FillBuffer waits for a new
+			   sender frame or the frame deadline, whichever comes first,
+			   instead of sleeping for the full time (SpoutDX WaitNewFrame)
+			   Add "timing" registry option for timing probes in FillBuffer
+			   and the SpoutDX receive functions. Statistics are written
+			   to the Spout log when the filter closes.
+	19.10.26   Settings service (settings.cpp). The registry is read once into
+			   a snapshot and a watcher thread loads a new snapshot when the
+			   key changes. Mirror, swap, flip, starting sender and options
+			   are applied by FillBuffer without re-starting the filter.
+			   The sender name is written to the registry by the watcher thread.
+	19.10.26   Multiple cameras. Up to four filters are registered with different
+			   names, CLSIDs and registry settings keys ("cameras" registry value).
+			   Pixel conversion is divided into bands of rows and run by worker
+			   threads shared by all cameras in the process (scheduler.cpp).
+	19.10.26   Add "frameshare" registry option. Converted frames are shared
+			   with SpoutCam in other applications through a shared memory ring
+			   so that each sender frame is converted once (frameshare.cpp).
+	19.10.26   Asynchronous logging while a stream is open so that logs
+			   do not delay FillBuffer (SpoutUtils EnableSpoutLogAsync).
+	19.10.26   Keep the last converted frame and deliver it again if there is
+			   no new sender frame. Previously the sample buffer was delivered
+			   unchanged, which may not be the last frame if the allocator has
+			   more than one buffer. Repeated samples are counted and timed
+			   as "SpoutCam::RepeatFrame" if timing is enabled.
+	19.10.26   Add "changedetect" registry option. Only rows of the sender
+			   frame that have changed are converted and identical frames
+			   are not converted. The frames and rows skipped are logged
+			   when the filter closes.
+	19.10.26   Add "fitmode" and "bordercolour" registry options. A sender
+			   of different aspect ratio to the camera resolution can be
+			   letterboxed or cropped instead of stretched.
+	19.10.26   Add "regionx", "regiony", "regionwidth" and "regionheight"
+			   registry options and ICamSettings2 put_SourceRegion and
+			   get_SourceRegion. Only the region of the sender is copied
+			   and converted. Resolution "Active sender" uses the region size.
+	19.10.26   Add "tonemap" and "exposure" registry options. Half float
+			   senders are tone mapped by the CPU conversion instead of
+			   clipping values greater than 1.
+	19.10.26   Add "brightness", "contrast", "gamma", "saturation",
+			   "blacklevel" and "whitelevel" registry options. Colour
+			   adjustment is applied by the pixel conversion.
+	19.10.26   Add "rotation" registry option. The sender is rotated
+			   90, 180 or 270 degrees clockwise by the pixel conversion.
+			   Resolution "Active sender" is the rotated sender size.
+	19.10.26   Static noise generated 64 bytes at a time by SSE2 xorshift
+			   generators (see noise.cpp). Add "staticmode" registry option
+			   to copy static from a pool of noise frames.
+	19.10.26   Add "pattern" registry option. SMPTE colour bars, ramps or a
+			   moving bar with frame number and stream time are shown
+			   instead of static (see pattern.cpp).
+	19.10.26   Add "timecode" registry option. The sender frame number and
+			   capture time are written as a block of cells to the top left
+			   corner for latency measurement (see SpoutTimecode.h).
+	19.10.26   get_SettingsKey, put_SourceRegion and get_SourceRegion moved
+			   to ICamSettings2 with a new IID. ICamSettings is unchanged.
+	19.10.26   The constructor applies the initial settings with ApplySettings
+			   instead of a copy of the same code.
 
 */
 
@@ -333,22 +391,10 @@
 
 #include "cam.h"
 
-// This is just a fast rand so that the static image isn't too slow for higher resolutions
-// Based on Marsaglia's xorshift generator (http://www.jstatsoft.org/v08/i14/paper)
-// and copied from (https://excamera.com/sphinx/article-xorshift.html)
-static uint32_t seed = 7; // 100% random seed value
-static uint32_t xorshiftRand()
-{
-	seed ^= seed << 13;
-	seed ^= seed >> 17;
-	seed ^= seed << 5;
-	return seed;
-}
-
 //////////////////////////////////////////////////////////////////////////
 //  CVCam is the source filter which masquerades as a capture device
 //////////////////////////////////////////////////////////////////////////
-CUnknown * WINAPI CVCam::CreateInstance(LPUNKNOWN lpunk, HRESULT *phr)
+CUnknown * WINAPI CVCam::CreateInstance(LPUNKNOWN lpunk, HRESULT *phr, int instance)
 {
     ASSERT(phr);
 
@@ -361,13 +407,17 @@ CUnknown * WINAPI CVCam::CreateInstance(LPUNKNOWN lpunk, HRESULT *phr)
 	// For clear options dialog for scaled display
 	SetProcessDPIAware();
 
-    CUnknown *punk = new CVCam(lpunk, phr);
+	if (instance < 0 || instance >= SPOUTCAM_INSTANCES)
+		instance = 0;
+
+    CUnknown *punk = new CVCam(lpunk, phr, instance);
 
     return punk;
 }
 
-CVCam::CVCam(LPUNKNOWN lpunk, HRESULT *phr) : 
-	CSource(NAME(SPOUTCAMNAME), lpunk, CLSID_SpoutCam) //VS: replaced SpoutCamName with makro SPOUTCAMNAME, NAME() expects LPCTSTR
+CVCam::CVCam(LPUNKNOWN lpunk, HRESULT *phr, int instance) : 
+	CSource(NAME(SPOUTCAMNAME), lpunk, *g_CamInstances[instance].clsid), //VS: replaced SpoutCamName with makro SPOUTCAMNAME, NAME() expects LPCTSTR
+	m_Instance(instance)
 {
     ASSERT(phr);
 
@@ -375,7 +425,7 @@ CVCam::CVCam(LPUNKNOWN lpunk, HRESULT *phr) :
     
 	// Create the one and only output pin
     m_paStreams = (CSourceStream **)new CVCamStream*[1];
-	m_paStreams[0] = new CVCamStream(phr, this, (LPCWSTR)&SpoutCamName);
+	m_paStreams[0] = new CVCamStream(phr, this, g_CamInstances[instance].name);
 
 	if (phr) *phr = S_OK; //VS
 }
@@ -392,6 +442,8 @@ HRESULT CVCam::QueryInterface(REFIID riid, void **ppv)
 	//<==================== VS-START ====================>
 	else if (riid == IID_ICamSettings)
 		return GetInterface((ICamSettings *)this, ppv);
+	else if (riid == IID_ICamSettings2)
+		return GetInterface((ICamSettings2 *)this, ppv);
 	else if (riid == IID_ISpecifyPropertyPages)
 		return GetInterface((ISpecifyPropertyPages *)this, ppv);
 	//<==================== VS-END ======================>
@@ -444,6 +496,42 @@ STDMETHODIMP CVCam::put_Settings(DWORD dwFps, DWORD dwResolution, DWORD dwMirror
 	return S_OK;
 }
 
+// Registry settings key of this camera for the properties dialog
+STDMETHODIMP CVCam::get_SettingsKey(char *key, int maxchars)
+{
+	CheckPointer(key, E_POINTER);
+	strcpy_s(key, maxchars, g_CamInstances[m_Instance].key);
+	return S_OK;
+}
+
+// Region of the sender to receive (zero width or height for the whole sender)
+// Saved to the registry settings of this camera and applied
+// by the streaming thread when the settings watcher has loaded them.
+STDMETHODIMP CVCam::put_SourceRegion(DWORD x, DWORD y, DWORD width, DWORD height)
+{
+	const char *key = g_CamInstances[m_Instance].key;
+	if (!WriteDwordToRegistry(HKEY_CURRENT_USER, key, "regionx", x)
+		|| !WriteDwordToRegistry(HKEY_CURRENT_USER, key, "regiony", y)
+		|| !WriteDwordToRegistry(HKEY_CURRENT_USER, key, "regionwidth", width)
+		|| !WriteDwordToRegistry(HKEY_CURRENT_USER, key, "regionheight", height))
+		return E_FAIL;
+	return S_OK;
+}
+
+STDMETHODIMP CVCam::get_SourceRegion(DWORD *x, DWORD *y, DWORD *width, DWORD *height)
+{
+	CheckPointer(x, E_POINTER);
+	CheckPointer(y, E_POINTER);
+	CheckPointer(width, E_POINTER);
+	CheckPointer(height, E_POINTER);
+	std::shared_ptr<const CamSettings> pSettings = ((CVCamStream *)m_paStreams[0])->settings.Get();
+	*x = pSettings->dwRegionX;
+	*y = pSettings->dwRegionY;
+	*width = pSettings->dwRegionWidth;
+	*height = pSettings->dwRegionHeight;
+	return S_OK;
+}
+
 //<==================== VS-END ======================>
 
 ///////////////////////////////////////////////////////////
@@ -580,6 +668,10 @@ HRESULT CVCamStream::put_Settings(DWORD dwFps, DWORD dwResolution, DWORD dwMirro
 // CVCamStream is the one and only output pin of CVCam which handles 
 // all the stuff.
 //////////////////////////////////////////////////////////////////////////
+
+// Streams using asynchronous logging in this process
+LONG CVCamStream::m_LogStreams = 0;
+
 CVCamStream::CVCamStream(HRESULT *phr, CVCam *pParent, LPCWSTR pPinName) :
 	CSourceStream(NAME(SPOUTCAMNAME), phr, pParent, pPinName), m_pParent(pParent) //VS: replaced SpoutCamName with makro SPOUTCAMNAME, NAME() expects LPCTSTR
 {
@@ -587,6 +679,7 @@ CVCamStream::CVCamStream(HRESULT *phr, CVCam *pParent, LPCWSTR pPinName) :
 	bMemoryMode		= false; // Default mode is texture, true means memoryshare
 	bInvert         = true;  // Flip vertically
 	bInitialized	= false; // Spoutcam receiver
+	bFrameWait		= false; // Sleep until the frame deadline
 	g_Width			= 640;	 // give it an initial size - this will be changed if a sender is running at start
 	g_Height		= 480;
 	g_SenderName[0] = 0;
@@ -621,81 +714,56 @@ CVCamStream::CVCamStream(HRESULT *phr, CVCam *pParent, LPCWSTR pPinName) :
 	timeBeginPeriod(g_caps.wPeriodMin);
 
 	//
-	// Retrieve fps and resolution from registry "SpoutCamSettings"
-	//		o Fps
-	//			10	0
-	//			15	1
-	//			25	2
-	//			30	3 (default)
-	// Compatibility problems with some software if > 60 fps
-	//			50	4
-	//			60	5
+	// Asynchronous logging
 	//
-	// Fps from SpoutCamSettings (default 3 = 30)
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "fps", &dwFps)) {
-		dwFps = 3;
-	}
-
-	//		o Resolution
-	//			Sender			0
-	//			320 x 240		1
-	//			640 x 360		2
-	//			640 x 480		3 (default if no sender)
-	//			800 x 600		4
-	//			1024 x 720		5	
-	//			1024 x 768		6
-	//			1280 x 720		7
-	//			1280 x 960		8
-	//			1280 x 1024		9
-	//			1920 x 1080		10
+	// Logs from FillBuffer are written to console and file by a
+	// background thread instead of the streaming thread. Logs that
+	// overflow the queue are dropped and counted. The thread is
+	// stopped when the last stream in the process closes, so that
+	// it does not hold the dll loaded.
 	//
-	// Resolution from SpoutCamSettings (default 0 = active sender)
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "resolution", &dwResolution))
-	{
-		dwResolution = 0;
-	}
-
-	// Find out whether memoryshare mode is selected by SpoutSettings
-	// (Memoryshare is not supported by DirectX)
-	bMemoryMode = receiver.GetMemoryShareMode();
+	if (InterlockedIncrement(&m_LogStreams) == 1)
+		EnableSpoutLogAsync();
 
 	//
-	// Options in SpoutCamSettings
+	// Load the settings snapshot and watch the registry for changes.
+	// Settings changed by SpoutCamSettings or the properties dialog
+	// are applied by FillBuffer while the filter is running, except
+	// for fps and resolution which require the filter to be re-started.
+	// See settings.cpp for the fps and resolution index values.
+	// Each camera has its own registry key.
 	//
+	settings.Start(g_CamInstances[pParent->GetInstance()].key);
+	std::shared_ptr<const CamSettings> pSettings = settings.Get();
 
-	// Mirror image
-	DWORD dwMirror = 0;
-	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "mirror", &dwMirror);
+	// Fps from SpoutCamSettings (default 3 = 30)
+	dwFps = pSettings->dwFps;
 
-	// RGB <> BGR
-	DWORD dwSwap = 0;
-	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "swap", &dwSwap);
+	// Resolution from SpoutCamSettings (default 0 = active sender)
+	dwResolution = pSettings->dwResolution;
 
-	// Flip image
-	// Default is flipped due to upside down Windows bitmap
-	// If set false, the result comes out inverted
-	// bInvert = false; 
-	DWORD dwFlip = 0;
-	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "flip", &dwFlip);
+	// Pixel conversion by the scheduler shared with other cameras
+	receiver.SetRowScheduler(&convert);
+
+	// Find out whether memoryshare mode is selected by SpoutSettings
+	// (Memoryshare is not supported by DirectX)
+	bMemoryMode = receiver.GetMemoryShareMode();
 
 	//
-	// Lock to a specific sender
+	// Orientation, starting sender and options in SpoutCamSettings
 	//
-	// SpoutCam will only connect to the name specified.
-	// Any other sender is ignored and SpoutCam will produce static until it opens.
-	// SpoutCam can be started before or after the sender.
-	// See SpoutCamSettings to specify the starting sender name.
-	// A starting name flags waiting for the nominated sender.
+	// Applied by ApplySettings, which also applies them when they change.
+	// Before put_Settings, because the "Active sender" resolution
+	// depends on the rotation and region.
 	//
-	g_SenderStart[0] = 0;
-	ReadPathFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "senderstart", g_SenderStart);
+	ApplySettings();
 
 	/*
 	printf("dwFps        = %d\n", dwFps);
 	printf("dwResolution = %d\n", dwResolution);
-	printf("dwMirror     = %d\n", dwMirror);
-	printf("dwFlip       = %d\n", dwFlip);
-	printf("dwSwap       = %d\n", dwSwap);
+	printf("dwMirror     = %d\n", pSettings->dwMirror);
+	printf("dwFlip       = %d\n", pSettings->dwFlip);
+	printf("dwSwap       = %d\n", pSettings->dwSwap);
 	printf("senderstart  [%s]\n", g_SenderStart);
 	*/
 
@@ -703,12 +771,15 @@ CVCamStream::CVCamStream(HRESULT *phr, CVCam *pParent, LPCWSTR pPinName) :
 	// Now always the new function put_Settings is called, which in turn calls
 	// SetFps and SetResolution. Dealing with resolution 0 (Sender) was moved to
 	// SetResolution.
-	put_Settings(dwFps, dwResolution, dwMirror, dwSwap, dwFlip, g_SenderStart);
+	put_Settings(dwFps, dwResolution, pSettings->dwMirror, pSettings->dwSwap, pSettings->dwFlip, g_SenderStart);
 	//<==================== VS-END ======================>
 
 	NumDroppedFrames = 0LL;
 	NumFrames = 0LL;
-
+	NumRepeatFrames = 0LL;
+	m_pLastBuffer = nullptr;
+	m_LastFrameSize = 0;
+	m_AllocBuffers = 1;
 
 }
 
@@ -766,6 +837,19 @@ void CVCamStream::SetResolution(DWORD dwResolution)
 
 					if (receiver.GetSenderInfo(g_SenderName, width, height, sharehandle, format))
 					{
+						// Use the size of the region received if one is set
+						unsigned int rx, ry, rwidth, rheight;
+						receiver.GetSourceRegion(rx, ry, rwidth, rheight);
+						if (rwidth > 0 && rheight > 0 && rx < width && ry < height) {
+							width  = (rwidth < width - rx) ? rwidth : (width - rx);
+							height = (rheight < height - ry) ? rheight : (height - ry);
+						}
+						// Rotated by 90 or 270 degrees
+						if (receiver.GetRotation() == 90 || receiver.GetRotation() == 270) {
+							const unsigned int rotated = width;
+							width = height;
+							height = rotated;
+						}
 						// If not fixed to the a selected resolution, use the sender width and height
 						// Width must be a multiple of 4
 						g_Width = (width/4)*4;
@@ -835,6 +919,27 @@ CVCamStream::~CVCamStream()
 	// End timer precision
 	timeEndPeriod(g_caps.wPeriodMin);
 
+	// Queued logs are written when the last stream closes
+	if (InterlockedDecrement(&m_LogStreams) == 0)
+		EnableSpoutLogAsync(false);
+
+	// Timing probe statistics to the log
+	if (SpoutTimingEnabled())
+		DumpSpoutTiming();
+
+	SpoutLogNotice("SpoutCam - %lld frames, %lld repeated, %lld dropped",
+		NumFrames, NumRepeatFrames, NumDroppedFrames);
+
+	if (receiver.GetChangeDetection()) {
+		long long frames = 0LL;
+		long long skippedframes = 0LL;
+		long long convertedbands = 0LL;
+		long long skippedbands = 0LL;
+		receiver.GetChangeCounts(frames, skippedframes, convertedbands, skippedbands);
+		SpoutLogNotice("SpoutCam - %lld frames checked, %lld unchanged, %lld of %lld row bands converted",
+			frames, skippedframes, convertedbands, convertedbands + skippedbands);
+	}
+
 } 
 
 HRESULT CVCamStream::QueryInterface(REFIID riid, void **ppv)
@@ -865,7 +970,7 @@ HRESULT CVCamStream::QueryInterface(REFIID riid, void **ppv)
 //////////////////////////////////////////////////////////////////////////
 HRESULT CVCamStream::FillBuffer(IMediaSample * pms) {
 	unsigned int imagesize, width, height = 0U;
-	long l, lDataLen = 0L;
+	long lDataLen = 0L;
 	bool bResult = false;
 	HRESULT hr = S_OK;
 	BYTE * pData = nullptr;
@@ -883,6 +988,10 @@ HRESULT CVCamStream::FillBuffer(IMediaSample * pms) {
 		return S_FALSE;
 	}
 
+	// Apply settings changed while the filter is running
+	if (settings.GetVersion() != m_SettingsVersion)
+		ApplySettings();
+
 	//
 	// Timing - modified from Red5 method
 	//
@@ -927,8 +1036,14 @@ HRESULT CVCamStream::FillBuffer(IMediaSample * pms) {
 		rtDelta2 = rtDelta - refSync2;
 		DWORD dwSleep = (DWORD)abs(rtDelta2/10000LL);
 		if (dwSleep >= 1) {
-			// More precise than "Sleep" in milliseconds
-			std::this_thread::sleep_for(std::chrono::microseconds(abs(rtDelta2/10LL)));
+			if (bFrameWait && bInitialized && receiver.IsFrameCountEnabled()) {
+				// Wake early for a new sender frame
+				receiver.WaitNewFrame(dwSleep);
+			}
+			else {
+				// More precise than "Sleep" in milliseconds
+				std::this_thread::sleep_for(std::chrono::microseconds(abs(rtDelta2/10LL)));
+			}
 		}
 	}
 	else if (rtDelta/avgFrameTime > NumDroppedFrames) {
@@ -950,6 +1065,12 @@ HRESULT CVCamStream::FillBuffer(IMediaSample * pms) {
 	hr = pms->SetSyncPoint(true);
 	// ============== END OF INITIAL TIMING ============
 
+	// Conversion deadline for the scheduler shared with other cameras
+	convert.SetDeadline(std::chrono::steady_clock::now() + std::chrono::microseconds(avgFrameTime/10LL));
+
+	// Time the remainder of FillBuffer if timing is enabled
+	SPOUT_TIMING("SpoutCam::FillBuffer");
+
 	// Check access to the sample's data buffer
     pms->GetPointer(&pData);
 	if (pData == NULL) {
@@ -987,6 +1108,7 @@ HRESULT CVCamStream::FillBuffer(IMediaSample * pms) {
 		// has now closed. Wait for it to open again.
 		// The last frame is frozen instead of showing static.
 		if (bInitialized && g_SenderStart[0]) {
+			RepeatLastFrame(pData, (long)size);
 			return NOERROR;
 		}
 		// Otherwise release and show static
@@ -1003,15 +1125,27 @@ HRESULT CVCamStream::FillBuffer(IMediaSample * pms) {
 		// bInvert : SpoutCamSettings or properites dialog user setting "flip"
 		// If IsUpdated() returns true, the sender has changed
 		if (receiver.IsUpdated()) {
+			// The static noise pool is not needed while receiving
+			noise.Release();
 			if (strcmp(g_SenderName, receiver.GetSenderName()) != 0) {
 				// Only test for change of sender name.
 				// The pixel buffer (pData) remains the same size and 
 				// ReceiveImage uses resampling for a different texture size
 				strcpy_s(g_SenderName, 256, receiver.GetSenderName());
 				// Set the sender name to the registry for SpoutCamSettings
-				WritePathToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "sendername", g_SenderName);
+				// The registry is written by the settings thread
+				settings.WriteSenderName(g_SenderName);
 			}
 		}
+		// A new frame is converted to the sample buffer and kept.
+		// If there is no new frame, ReceiveImage does not change
+		// the sample buffer, so deliver the last frame again.
+		if (receiver.IsFrameNew())
+			SaveLastFrame(pData, (long)size);
+		else
+			RepeatLastFrame(pData, (long)size);
+		// Sample buffers no longer hold the test pattern
+		pattern.Reset();
 		bInitialized = true;
 		NumFrames++;
 		return NOERROR;
@@ -1019,6 +1153,7 @@ HRESULT CVCamStream::FillBuffer(IMediaSample * pms) {
 	else {
 		// Return if waiting for a starting sender that has closed.
 		if (bInitialized && g_SenderStart[0]) {
+			RepeatLastFrame(pData, (long)size);
 			return NOERROR;
 		}
 		// Release the receiver 
@@ -1030,8 +1165,20 @@ ShowStatic :
 	// drop through to default static image if it did not work
 	pms->GetPointer(&pData);
 	lDataLen = pms->GetSize();
-	for (l = 0; l < lDataLen; ++l)
-		pData[l] = (char)xorshiftRand(); // fast rand();
+	// Test pattern if selected, otherwise static noise.
+	// The pattern is drawn upright in the same way as received frames.
+	if (!pattern.Draw(pData, lDataLen, width, height, (unsigned int)pvi->bmiHeader.biBitCount/8,
+		bInvert, nPattern, NumFrames, rtNow)) {
+		pattern.Reset();
+		if (bStaticPool)
+			noise.FillFromPool(pData, lDataLen);
+		else
+			noise.Fill(pData, lDataLen);
+	}
+
+	// The sample buffer no longer holds the last frame
+	if (pData == m_pLastBuffer)
+		m_pLastBuffer = nullptr;
 
 	NumFrames++;
 
@@ -1047,6 +1194,223 @@ void CVCamStream::ReleaseCamReceiver()
 		receiver.ReleaseReceiver();
 		bInitialized = false;
 	}
+	// No last frame to repeat
+	m_pLastBuffer = nullptr;
+	m_LastFrameSize = 0;
+}
+
+//
+// Keep the last converted frame
+//
+// If the allocator has one buffer, every sample uses it and the frame
+// is not copied. Otherwise the frame is copied. The copy is only
+// re-allocated if the frame size changes.
+//
+void CVCamStream::SaveLastFrame(BYTE *pData, long size)
+{
+	m_pLastBuffer = pData;
+	m_LastFrameSize = size;
+	if (m_AllocBuffers > 1) {
+		if (m_LastFrame.size() != (size_t)size)
+			m_LastFrame.resize(size);
+		memcpy(m_LastFrame.data(), pData, size);
+	}
+}
+
+//
+// Deliver the last converted frame again
+//
+// Nothing is copied if the sample buffer already holds the frame.
+// Returns false if there is no last frame to repeat.
+//
+bool CVCamStream::RepeatLastFrame(BYTE *pData, long size)
+{
+	if (!pData || m_LastFrameSize == 0 || size != m_LastFrameSize)
+		return false;
+
+	SPOUT_TIMING("SpoutCam::RepeatFrame");
+
+	if (pData != m_pLastBuffer) {
+		if (m_AllocBuffers < 2 || m_LastFrame.size() != (size_t)size)
+			return false;
+		memcpy(pData, m_LastFrame.data(), size);
+		m_pLastBuffer = pData;
+	}
+	NumRepeatFrames++;
+
+	return true;
+}
+
+//
+// Apply a new settings snapshot
+//
+// Called by the constructor for the initial settings and by FillBuffer
+// when the settings watcher has loaded new settings.
+// Orientation, colour and options take effect from the next frame.
+// Fps and resolution change the media type and still require
+// the filter to be re-started.
+//
+void CVCamStream::ApplySettings()
+{
+	m_SettingsVersion = settings.GetVersion();
+	std::shared_ptr<const CamSettings> pSettings = settings.Get();
+
+	// Mirror image
+	receiver.SetMirror(pSettings->dwMirror > 0);
+
+	// RGB <> BGR
+	receiver.SetSwap(pSettings->dwSwap > 0);
+
+	// Flip image
+	// Default is flipped due to upside down Windows bitmap
+	// If set false, the result comes out inverted
+	bInvert = !(pSettings->dwFlip > 0);
+
+	// Rotate image
+	// 0, 90, 180 or 270 degrees clockwise, applied before mirror and flip
+	receiver.SetRotation(pSettings->dwRotation);
+
+	//
+	// Wait for a new frame
+	//
+	// When connected to a sender, FillBuffer waits until the sender
+	// signals a new frame or the frame deadline arrives, whichever
+	// comes first, instead of sleeping until the deadline.
+	// Requires frame counting ("Framecount" in SpoutSettings).
+	// Senders that do not signal new frames wait for the deadline as before.
+	//
+	bFrameWait = (pSettings->dwFrameWait > 0);
+
+	//
+	// Timing probes
+	//
+	// Record FillBuffer and receiving times.
+	// Enable logging to see the results when the filter closes.
+	//
+	if (SpoutTimingEnabled() != (pSettings->dwTiming > 0))
+		EnableSpoutTiming(pSettings->dwTiming > 0);
+
+	//
+	// Share converted frames
+	//
+	// When several applications use SpoutCam at the same time, the first
+	// to convert a sender frame shares the pixels and the others copy them.
+	// Requires frame counting ("Framecount" in SpoutSettings).
+	// The shared memory is closed if sharing is switched off.
+	//
+	receiver.SetFrameCache(pSettings->dwFrameShare > 0 ? &frameshare : nullptr);
+	if (pSettings->dwFrameShare == 0)
+		frameshare.Close();
+
+	//
+	// Change detection
+	//
+	// Convert only rows of the sender frame that have changed.
+	// Useful for senders with mostly static content.
+	//
+	if (receiver.GetChangeDetection() != (pSettings->dwChangeDetect > 0))
+		receiver.SetChangeDetection(pSettings->dwChangeDetect > 0);
+
+	//
+	// Fit mode
+	//
+	// For a sender of different aspect ratio to the camera resolution
+	//		0 - stretch (default)
+	//		1 - letterbox with borders of "bordercolour" (0xRRGGBB)
+	//		2 - crop to fill
+	//
+	receiver.SetFitMode((int)pSettings->dwFitMode);
+	receiver.SetBorderColour(pSettings->dwBorderColour);
+
+	//
+	// Region of the sender to receive
+	//
+	// Only the region is copied from the sender texture and converted.
+	// Zero width or height for the whole sender (default).
+	//
+	receiver.SetSourceRegion(pSettings->dwRegionX, pSettings->dwRegionY,
+		pSettings->dwRegionWidth, pSettings->dwRegionHeight);
+
+	//
+	// Tone mapping
+	//
+	// For half float senders with values greater than 1
+	//		0 - clamp (default)
+	//		1 - Reinhard
+	//		2 - ACES filmic
+	// "exposure" is a percentage (default 100)
+	//
+	receiver.SetToneMapping((int)pSettings->dwToneMap,
+		pSettings->dwExposure > 0 ? (float)pSettings->dwExposure/100.0f : 1.0f);
+
+	//
+	// Colour adjustment
+	//
+	// "brightness" percent, negative to darken (default 0)
+	// "contrast", "gamma" x 100 and "saturation" percent (default 100)
+	// "blacklevel" and "whitelevel" input levels (default 0 and 255)
+	//
+	receiver.SetColourAdjust((float)(int)pSettings->dwBrightness/100.0f,
+		pSettings->dwContrast > 0 ? (float)pSettings->dwContrast/100.0f : 1.0f,
+		pSettings->dwGamma > 0 ? (float)pSettings->dwGamma/100.0f : 1.0f,
+		pSettings->dwSaturation > 0 ? (float)pSettings->dwSaturation/100.0f : 1.0f,
+		pSettings->dwBlackLevel, pSettings->dwWhiteLevel > 0 ? pSettings->dwWhiteLevel : 255);
+
+	//
+	// Static image when there is no sender
+	//
+	// 0 - new noise for each frame (default)
+	// 1 - noise copied from a pool of frames
+	//
+	// The pool is released if it is no longer used.
+	//
+	bStaticPool = (pSettings->dwStaticMode > 0);
+	if (!bStaticPool)
+		noise.Release();
+
+	//
+	// Test pattern instead of static
+	//
+	// 0 - static (default)
+	// 1 - SMPTE colour bars
+	// 2 - grey, red, green and blue ramps
+	// 3 - moving bar with frame number and stream time
+	//
+	nPattern = (int)pSettings->dwPattern;
+
+	//
+	// Timecode watermark
+	//
+	// 0 - none (default)
+	// 1 - block of 4 pixel cells in the top left corner
+	// >1 - cell size in pixels
+	//
+	// The frame number and capture time are read from a recording or
+	// raw frame dumps of the receiving application by SpoutTimecode.exe
+	//
+	receiver.SetTimecode(pSettings->dwTimecode > 0,
+		pSettings->dwTimecode > 1 ? pSettings->dwTimecode : SPOUT_TIMECODE_CELL);
+
+	//
+	// Lock to a specific sender
+	//
+	// SpoutCam will only connect to the name specified.
+	// Any other sender is ignored and SpoutCam will produce static until it opens.
+	// SpoutCam can be started before or after the sender.
+	// See SpoutCamSettings to specify the starting sender name.
+	// A starting name flags waiting for the nominated sender.
+	//
+	// For a change of name, release the receiver to connect to the new sender.
+	//
+	if (strcmp(g_SenderStart, pSettings->senderstart) != 0) {
+		strcpy_s(g_SenderStart, 256, pSettings->senderstart);
+		receiver.SetReceiverName(g_SenderStart);
+		ReleaseCamReceiver();
+	}
+
+	if (pSettings->dwFps != dwFps || pSettings->dwResolution != dwResolution)
+		SpoutLogNotice("SpoutCam - for change of resolution or fps, stop and re-start SpoutCam");
+
 }
 
 
@@ -1171,6 +1535,11 @@ HRESULT CVCamStream::DecideBufferSize(IMemAllocator *pAlloc, ALLOCATOR_PROPERTIE
 	// Is this allocator unsuitable?
     if(Actual.cbBuffer < pProperties->cbBuffer) return E_FAIL;
 
+	// The last frame is copied for repeats if there is more than one buffer
+	m_AllocBuffers = Actual.cBuffers;
+	m_pLastBuffer = nullptr;
+	m_LastFrameSize = 0;
+
     return NOERROR;
 
 } // DecideBufferSize
@@ -10,6 +10,11 @@
 //	17.10.19 - Clean up for DirectX methods
 //	13.10.20 - Clean up unused variables
 //	20.10.20 - Clean up std::chrono debugging
+//	19.10.26 - Settings service for registry settings
+//	19.10.26 - Multiple camera instances and shared conversion scheduler
+//	19.10.26 - Converted frame sharing between processes
+//	19.10.26 - Last frame repeat
+//	19.10.26 - ICamSettings2 for the settings key and source region
 //
 
 #pragma once
@@ -34,6 +39,11 @@
 
 //<==================== VS-START ====================>
 #include "dshowutil.h"
+#include "settings.h"
+#include "scheduler.h"
+#include "frameshare.h"
+#include "noise.h"
+#include "pattern.h"
 
 // we need a LPCTSTR for the NAME() makros in debug mode
 #define SPOUTCAMNAME "SpoutCam"
@@ -50,27 +60,70 @@ extern "C" {
 			const char *name
 			) PURE;
 	};
+
+	// Extended settings interface
+	// ICamSettings is published and is not changed.
+	DECLARE_INTERFACE_(ICamSettings2, ICamSettings)
+	{
+		STDMETHOD(get_SettingsKey) (THIS_
+			char *key,
+			int maxchars
+			) PURE;
+		STDMETHOD(put_SourceRegion) (THIS_
+			DWORD x,
+			DWORD y,
+			DWORD width,
+			DWORD height
+			) PURE;
+		STDMETHOD(get_SourceRegion) (THIS_
+			DWORD *x,
+			DWORD *y,
+			DWORD *width,
+			DWORD *height
+			) PURE;
+	};
 }
 
 EXTERN_C const GUID CLSID_SpoutCamPropertyPage;
 EXTERN_C const GUID IID_ICamSettings;
+EXTERN_C const GUID IID_ICamSettings2;
 //<==================== VS-END ======================>
 
 EXTERN_C const GUID CLSID_SpoutCam;
 EXTERN_C const WCHAR SpoutCamName[MAX_PATH];
 
+//
+// Camera instances
+//
+// Each camera registered by this module has a name, CLSID and registry
+// settings key. The first is "SpoutCam" with the original CLSID and key.
+// The number registered is the "cameras" value of the first key.
+//
+#define SPOUTCAM_INSTANCES 4
+
+struct SpoutCamInstance {
+	const WCHAR *name;  // Filter name
+	const GUID *clsid;  // Filter CLSID
+	const char *key;    // Registry settings key
+};
+
+extern const SpoutCamInstance g_CamInstances[SPOUTCAM_INSTANCES];
+
 class CVCamStream;
 class CVCam : public CSource,
 	public ISpecifyPropertyPages,//VS
-	public ICamSettings//VS
+	public ICamSettings2//VS
 {
 public:
     //////////////////////////////////////////////////////////////////////////
     //  IUnknown
     //////////////////////////////////////////////////////////////////////////
-    static CUnknown * WINAPI CreateInstance(LPUNKNOWN lpunk, HRESULT *phr);
+    static CUnknown * WINAPI CreateInstance(LPUNKNOWN lpunk, HRESULT *phr, int instance = 0);
     STDMETHODIMP QueryInterface(REFIID riid, void **ppv);
 
+	// Camera instance index
+	int GetInstance() { return m_Instance; }
+
 	// LJ additons
 	STDMETHODIMP GetState(DWORD dwMSecs, FILTER_STATE *State);
 
@@ -84,11 +137,17 @@ public:
 
 	// ICamSettings interface
 	STDMETHODIMP put_Settings(DWORD dwFps, DWORD dwResolution, DWORD dwMirror, DWORD dwSwap, DWORD dwFlip, const char *name);
+	// ICamSettings2 interface
+	STDMETHODIMP get_SettingsKey(char *key, int maxchars);
+	STDMETHODIMP put_SourceRegion(DWORD x, DWORD y, DWORD width, DWORD height);
+	STDMETHODIMP get_SourceRegion(DWORD *x, DWORD *y, DWORD *width, DWORD *height);
 	//<==================== VS-END ======================>
 
 private:
 
-    CVCam(LPUNKNOWN lpunk, HRESULT *phr);
+    CVCam(LPUNKNOWN lpunk, HRESULT *phr, int instance);
+
+	int m_Instance; // Camera instance index
 
 /////////////////////////////////////
 // all inherited virtual functions //
@@ -202,6 +261,9 @@ public:
 	void SetFps(DWORD dwFps);
 	void SetResolution(DWORD dwResolution);
 	void ReleaseCamReceiver();
+	void ApplySettings();
+	void SaveLastFrame(BYTE *pData, long size);
+	bool RepeatLastFrame(BYTE *pData, long size);
 
 	// ============== IPC functions ==============
 	//
@@ -217,6 +279,7 @@ public:
 	bool bInvert;                // Flip vertically
 	bool bInitialized;
 	bool bDXinitialized;
+	bool bFrameWait;             // Wait for a new sender frame instead of sleeping
 
 	unsigned int g_Width;			 // The global filter image width
 	unsigned int g_Height;			 // The global filter image height
@@ -225,11 +288,28 @@ public:
 	DWORD dwResolution;				// Resolution from SpoutCamConfig
 	int g_FrameTime;                // Frame time to use based on fps selection
 	TIMECAPS g_caps;                // Timer capability for Sleep precision
+	static LONG m_LogStreams;       // Streams using asynchronous logging
+	CCamSettingsService settings;   // Registry settings snapshot and watcher
+	CConvertClient convert;         // Pixel conversion by the shared scheduler
+	CFrameShare frameshare;         // Converted frames shared with other processes
+	CStaticNoise noise;             // Static image when there is no sender
+	bool bStaticPool;               // Copy static from a pool of noise frames
+	CTestPattern pattern;           // Test pattern instead of static
+	int nPattern;                   // Test pattern (SPOUTCAM_PATTERN_NONE for static)
 
 private:
 
 	CVCam *m_pParent;
 	long long NumDroppedFrames, NumFrames;
+	long long NumRepeatFrames;      // Samples delivered with the last frame
+
+	// Last converted frame
+	// The sample buffer holds the frame if the allocator has one buffer.
+	// Otherwise the frame is copied so that it can be delivered again.
+	std::vector<BYTE> m_LastFrame;  // Copy of the last frame
+	BYTE *m_pLastBuffer;            // Sample buffer holding the last frame
+	long m_LastFrameSize;           // Size of the last frame (0 if none)
+	long m_AllocBuffers;            // Number of allocator buffers
 	REFERENCE_TIME 
 		m_rtLastTime,	// running timestamp
 		refSync1,		// Graphmanager clock time, to compute dropped frames.
@@ -238,6 +318,7 @@ private:
 		rtStreamOff;	// IAMPushSource Get/Set data member.
 
 	DWORD dwLastTime;
+	LONG m_SettingsVersion;         // Version of the settings last applied
     CCritSec m_cSharedState;
     IReferenceClock *m_pClock;
 
@@ -34,6 +34,7 @@ CSpoutCamProperties::CSpoutCamProperties(LPUNKNOWN pUnk, HRESULT *phr) :
 	m_bIsInitialized(FALSE)
 {
 	ASSERT(phr);
+	strcpy_s(m_Key, 256, SPOUTCAM_REGISTRY_KEY);
 	if (phr)
 		*phr = S_OK;
 }
@@ -151,6 +152,16 @@ HRESULT CSpoutCamProperties::OnConnect(IUnknown *pUnknown)
 	// Get the initial image FX property
 	CheckPointer(m_pCamSettings, E_FAIL);
 
+	// Registry settings key of the camera
+	// The original key if the filter does not have ICamSettings2
+	strcpy_s(m_Key, 256, SPOUTCAM_REGISTRY_KEY);
+	ICamSettings2 *pCamSettings2 = NULL;
+	if (SUCCEEDED(pUnknown->QueryInterface(IID_ICamSettings2, (void **)&pCamSettings2))) {
+		if (FAILED(pCamSettings2->get_SettingsKey(m_Key, 256)))
+			strcpy_s(m_Key, 256, SPOUTCAM_REGISTRY_KEY);
+		pCamSettings2->Release();
+	}
+
 	m_bIsInitialized = FALSE;
 
 	return S_OK;
@@ -185,7 +196,7 @@ HRESULT CSpoutCamProperties::OnActivate()
 	////////////////////////////////////////
 
 	// Retrieve fps from registry
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "fps", &dwValue) || dwValue > 5)
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "fps", &dwValue) || dwValue > 5)
 	{
 		dwValue = 3; // default 3 = 30 fps
 	}
@@ -220,7 +231,7 @@ HRESULT CSpoutCamProperties::OnActivate()
 	////////////////////////////////////////
 
 	// Retrieve resolution from registry "SpoutCamConfig"
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "resolution", &dwValue) || dwValue > 10)
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "resolution", &dwValue) || dwValue > 10)
 	{
 		dwValue = 0; // default 0 = active sender
 	}
@@ -258,7 +269,7 @@ HRESULT CSpoutCamProperties::OnActivate()
 	////////////////////////////////////////
 
 	// Note - registry read is not wide chars
-	if (!ReadPathFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "senderstart", name))
+	if (!ReadPathFromRegistry(HKEY_CURRENT_USER, m_Key, "senderstart", name))
 	{
 		wname[0] = 0;
 	}
@@ -274,7 +285,7 @@ HRESULT CSpoutCamProperties::OnActivate()
 	////////////////////////////////////////
 	// Mirror image
 	////////////////////////////////////////
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "mirror", &dwValue))
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "mirror", &dwValue))
 	{
 		dwValue = 0;
 	}
@@ -284,7 +295,7 @@ HRESULT CSpoutCamProperties::OnActivate()
 	////////////////////////////////////////
 	// Swap RGB <> BGR
 	////////////////////////////////////////
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "swap", &dwValue))
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "swap", &dwValue))
 	{
 		dwValue = 0;
 	}
@@ -297,7 +308,7 @@ HRESULT CSpoutCamProperties::OnActivate()
 	// If set false, the result comes out inverted
 	// bInvert = false;
 	////////////////////////////////////////
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "flip", &dwValue))
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "flip", &dwValue))
 	{
 		dwValue = 0;
 	}
@@ -305,7 +316,7 @@ HRESULT CSpoutCamProperties::OnActivate()
 	Button_SetCheck(hwndCtl, dwValue);
 
 	// Warning disable mode
-	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "silent", &dwValue))
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "silent", &dwValue))
 	{
 		dwValue = 0; // Disable warnings off by default
 	}
@@ -347,8 +358,8 @@ HRESULT CSpoutCamProperties::OnApplyChanges()
 	// =================================
 	// Get old fps and resolution for user warning
 	DWORD dwOldFps, dwOldResolution;
-	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "fps", &dwOldFps);
-	ReadDwordFromRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "resolution", &dwOldResolution);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "fps", &dwOldFps);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "resolution", &dwOldResolution);
 	dwFps = ComboBox_GetCurSel(GetDlgItem(this->m_Dlg, IDC_FPS));
 	dwResolution = ComboBox_GetCurSel(GetDlgItem(this->m_Dlg, IDC_RESOLUTION));
 	// Warn unless disabled
@@ -363,8 +374,8 @@ HRESULT CSpoutCamProperties::OnApplyChanges()
 			}
 		}
 	}
-	WriteDwordToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "fps", dwFps);
-	WriteDwordToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "resolution", dwResolution);
+	WriteDwordToRegistry(HKEY_CURRENT_USER, m_Key, "fps", dwFps);
+	WriteDwordToRegistry(HKEY_CURRENT_USER, m_Key, "resolution", dwResolution);
 	// =================================
 
 	// If properties is implemented, the dialog may need to be updated 
@@ -374,23 +385,23 @@ HRESULT CSpoutCamProperties::OnApplyChanges()
 	Edit_GetText(hwndCtl, wname, 256);
 	size_t convertedChars = 0;
 	wcstombs_s(&convertedChars, name, 256, wname, _TRUNCATE);
-	WritePathToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "senderstart", name);
+	WritePathToRegistry(HKEY_CURRENT_USER, m_Key, "senderstart", name);
 
 	hwndCtl = GetDlgItem(this->m_Dlg, IDC_MIRROR);
 	dwMirror = Button_GetCheck(hwndCtl);
-	WriteDwordToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "mirror", dwMirror);
+	WriteDwordToRegistry(HKEY_CURRENT_USER, m_Key, "mirror", dwMirror);
 
 	hwndCtl = GetDlgItem(this->m_Dlg, IDC_SWAP);
 	dwSwap = Button_GetCheck(hwndCtl);
-	WriteDwordToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "swap", dwSwap);
+	WriteDwordToRegistry(HKEY_CURRENT_USER, m_Key, "swap", dwSwap);
 
 	hwndCtl = GetDlgItem(this->m_Dlg, IDC_FLIP);
 	dwFlip = Button_GetCheck(hwndCtl);
-	WriteDwordToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "flip", dwFlip);
+	WriteDwordToRegistry(HKEY_CURRENT_USER, m_Key, "flip", dwFlip);
 
 	// Silent mode is set only by the properties dialog
 	dwSilent = Button_GetCheck(GetDlgItem(this->m_Dlg, IDC_SILENT));
-	WriteDwordToRegistry(HKEY_CURRENT_USER, "Software\\Leading Edge\\SpoutCam", "silent", dwSilent);
+	WriteDwordToRegistry(HKEY_CURRENT_USER, m_Key, "silent", dwSilent);
 	
 	if (m_pCamSettings)
 		m_pCamSettings->put_Settings(dwFps, dwResolution, dwMirror, dwSwap, dwFlip, name);
@@ -21,5 +21,6 @@ private:
 	BOOL m_bIsInitialized;          // Used to ignore startup messages
 	BOOL m_bSilent;                 // Disable warnings mode
 	ICamSettings *m_pCamSettings;   // The custom interface on the filter
+	char m_Key[256];                // Registry settings key of the filter
 };
 
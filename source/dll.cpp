@@ -46,24 +46,43 @@ const WCHAR SpoutCamName[] = L"" SPOUTCAMNAME;
 //
 // For multiple cameras :
 //
-// 1) Change the name as above
-// 2) Increment the last value of the CLSID e.g. 0x33, 0x34 etc.
+// Up to SPOUTCAM_INSTANCES cameras are registered by this module, each with
+// a different name, CLSID and registry settings key. The number registered
+// is the "cameras" value of the "Software\Leading Edge\SpoutCam" key
+// (default 1). Re-register with regsvr32 after changing it.
 //
-// Then a separate camera with a different name and CLSID can be registered.
-// Importantly, the resulting ".ax" files should be saved in different locations
-// with different file names, so that they can be registered/unregistered separately.
-// Match the file name with the camera name above to keep track of what you are doing.
-// 
-// You must use regsvr32 for registration.
-// SpoutCamSettings is hard-coded for SpoutCam but can still be used to set fps
-// and resolution. These settings are recorded in the registry and will be 
-// picked up by all versions of SpoutCam, regardless of the name.
+//	SpoutCam	{8E14549A-DB61-4309-AFA1-3578E927E933}	...\SpoutCam
+//	SpoutCam2	{8E14549A-DB61-4309-AFA1-3578E927E934}	...\SpoutCam2
+//	SpoutCam3	{8E14549A-DB61-4309-AFA1-3578E927E935}	...\SpoutCam3
+//	SpoutCam4	{8E14549A-DB61-4309-AFA1-3578E927E936}	...\SpoutCam4
 //
-// When returning to the default SpoutCam, change the CLSID to back to the original
-// {8E14549A-DB61-4309-AFA1-3578E927E933}
-// 0x8e14549a, 0xdb61, 0x4309, 0xaf, 0xa1, 0x35, 0x78, 0xe9, 0x27, 0xe9, 0x33
+// Each camera has its own settings, including the starting sender name,
+// so that the cameras can receive from different senders. The properties
+// dialog of each camera shows and changes the settings for that camera.
+// SpoutCamSettings is hard-coded for the first camera.
+//
+// Separate modules with different names and CLSIDs can still be built
+// by changing the name above and the CLSIDs below. The ".ax" files should
+// be saved in different locations so that they can be registered separately.
 //
 DEFINE_GUID(CLSID_SpoutCam, 0x8e14549a, 0xdb61, 0x4309, 0xaf, 0xa1, 0x35, 0x78, 0xe9, 0x27, 0xe9, 0x33);
+DEFINE_GUID(CLSID_SpoutCam2, 0x8e14549a, 0xdb61, 0x4309, 0xaf, 0xa1, 0x35, 0x78, 0xe9, 0x27, 0xe9, 0x34);
+DEFINE_GUID(CLSID_SpoutCam3, 0x8e14549a, 0xdb61, 0x4309, 0xaf, 0xa1, 0x35, 0x78, 0xe9, 0x27, 0xe9, 0x35);
+DEFINE_GUID(CLSID_SpoutCam4, 0x8e14549a, 0xdb61, 0x4309, 0xaf, 0xa1, 0x35, 0x78, 0xe9, 0x27, 0xe9, 0x36);
+
+const SpoutCamInstance g_CamInstances[SPOUTCAM_INSTANCES] =
+{
+	{ SpoutCamName,             &CLSID_SpoutCam,  SPOUTCAM_REGISTRY_KEY },
+	{ L"" SPOUTCAMNAME "2",     &CLSID_SpoutCam2, SPOUTCAM_REGISTRY_KEY "2" },
+	{ L"" SPOUTCAMNAME "3",     &CLSID_SpoutCam3, SPOUTCAM_REGISTRY_KEY "3" },
+	{ L"" SPOUTCAMNAME "4",     &CLSID_SpoutCam4, SPOUTCAM_REGISTRY_KEY "4" }
+};
+
+// Factory function for each camera
+template <int N> CUnknown * WINAPI CreateCamInstance(LPUNKNOWN lpunk, HRESULT *phr)
+{
+	return CVCam::CreateInstance(lpunk, phr, N);
+}
 
 //<==================== VS-START ====================>
 // And the property page we support
@@ -75,6 +94,10 @@ DEFINE_GUID(CLSID_SpoutCamPropertyPage,
 // {6CD0D97B-C242-48DA-916D-28856D00754B}
 DEFINE_GUID(IID_ICamSettings,
 	0x6cd0d97b, 0xc242, 0x48da, 0x91, 0x6d, 0x28, 0x85, 0x6d, 0x00, 0x75, 0x4b);
+
+// {63B2B169-32DF-4FB2-8A7E-0CAB965DDD7C}
+DEFINE_GUID(IID_ICamSettings2,
+	0x63b2b169, 0x32df, 0x4fb2, 0x8a, 0x7e, 0x0c, 0xab, 0x96, 0x5d, 0xdd, 0x7c);
 //<==================== VS-END ======================>
 
 const AMOVIESETUP_MEDIATYPE AMSMediaTypesVCam = 
@@ -96,25 +119,23 @@ const AMOVIESETUP_PIN AMSPinVCam=
     &AMSMediaTypesVCam     // Pointer to media types
 };
 
-const AMOVIESETUP_FILTER AMSFilterVCam =
+// Filter merit MERIT_DO_NOT_USE is recommended for capture
+// (http://msdn.microsoft.com/en-us/library/windows/desktop/dd388793%28v=vs.85%29.aspx)
+const AMOVIESETUP_FILTER AMSFilterVCam[SPOUTCAM_INSTANCES] =
 {
-    &CLSID_SpoutCam,	// Filter CLSID
-	SpoutCamName,		// String name
-    MERIT_DO_NOT_USE,   // Filter merit
-						// Recommended for capture (http://msdn.microsoft.com/en-us/library/windows/desktop/dd388793%28v=vs.85%29.aspx)
-    1,                  // Number pins
-    &AMSPinVCam         // Pointer to pin information
+	// Filter CLSID, string name, filter merit, number pins, pointer to pin information
+	{ &CLSID_SpoutCam,  g_CamInstances[0].name, MERIT_DO_NOT_USE, 1, &AMSPinVCam },
+	{ &CLSID_SpoutCam2, g_CamInstances[1].name, MERIT_DO_NOT_USE, 1, &AMSPinVCam },
+	{ &CLSID_SpoutCam3, g_CamInstances[2].name, MERIT_DO_NOT_USE, 1, &AMSPinVCam },
+	{ &CLSID_SpoutCam4, g_CamInstances[3].name, MERIT_DO_NOT_USE, 1, &AMSPinVCam }
 };
 
 CFactoryTemplate g_Templates[] = 
 {
-    {
-		SpoutCamName,
-        &CLSID_SpoutCam,
-        CVCam::CreateInstance,
-        NULL,
-        &AMSFilterVCam
-    }
+	{ g_CamInstances[0].name, &CLSID_SpoutCam,  CreateCamInstance<0>, NULL, &AMSFilterVCam[0] },
+	{ g_CamInstances[1].name, &CLSID_SpoutCam2, CreateCamInstance<1>, NULL, &AMSFilterVCam[1] },
+	{ g_CamInstances[2].name, &CLSID_SpoutCam3, CreateCamInstance<2>, NULL, &AMSFilterVCam[2] },
+	{ g_CamInstances[3].name, &CLSID_SpoutCam4, CreateCamInstance<3>, NULL, &AMSFilterVCam[3] }
 	//<==================== VS-START ====================>
 	,
 	{
@@ -152,10 +173,19 @@ STDAPI RegisterFilters( BOOL bRegister )
 	}
 	//<==================== VS-END ====================>
 
+	// Number of cameras to register (default 1)
+	// All cameras are unregistered
+	DWORD dwCameras = 1;
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, SPOUTCAM_REGISTRY_KEY, "cameras", &dwCameras);
+	if (dwCameras < 1) dwCameras = 1;
+	if (dwCameras > SPOUTCAM_INSTANCES) dwCameras = SPOUTCAM_INSTANCES;
+	const int nCameras = bRegister ? (int)dwCameras : SPOUTCAM_INSTANCES;
+
     hr = CoInitialize(0);
     if(bRegister)
     {
-		hr = AMovieSetupRegisterServer(CLSID_SpoutCam, SpoutCamName, achFileName, L"Both", L"InprocServer32");
+		for (int i = 0; i < nCameras; i++)
+			hr = AMovieSetupRegisterServer(*g_CamInstances[i].clsid, g_CamInstances[i].name, achFileName, L"Both", L"InprocServer32");
 		hr = AMovieSetupRegisterServer(CLSID_SpoutCamPropertyPage, L"Settings", achFileName, L"Both", L"InprocServer32"); //VS
     }
 
@@ -165,20 +195,24 @@ STDAPI RegisterFilters( BOOL bRegister )
         hr = CreateComObject( CLSID_FilterMapper2, IID_IFilterMapper2, fm );
         if( SUCCEEDED(hr) )
         {
-            if(bRegister)
-            {
-                IMoniker *pMoniker = 0;
-                REGFILTER2 rf2;
-                rf2.dwVersion = 1;
-                rf2.dwMerit = MERIT_DO_NOT_USE;
-                rf2.cPins = 1;
-                rf2.rgPins = &AMSPinVCam;
-				hr = fm->RegisterFilter(CLSID_SpoutCam, SpoutCamName, &pMoniker, &CLSID_VideoInputDeviceCategory, NULL, &rf2);
-            }
-            else
-            {
-                hr = fm->UnregisterFilter(&CLSID_VideoInputDeviceCategory, 0, CLSID_SpoutCam);
-            }
+			for (int i = 0; i < nCameras; i++) {
+				if(bRegister)
+				{
+					IMoniker *pMoniker = 0;
+					REGFILTER2 rf2;
+					rf2.dwVersion = 1;
+					rf2.dwMerit = MERIT_DO_NOT_USE;
+					rf2.cPins = 1;
+					rf2.rgPins = &AMSPinVCam;
+					hr = fm->RegisterFilter(*g_CamInstances[i].clsid, g_CamInstances[i].name, &pMoniker, &CLSID_VideoInputDeviceCategory, NULL, &rf2);
+				}
+				else
+				{
+					// Cameras that are not registered fail and are ignored
+					HRESULT hrCam = fm->UnregisterFilter(&CLSID_VideoInputDeviceCategory, 0, *g_CamInstances[i].clsid);
+					if (i == 0) hr = hrCam;
+				}
+			}
         }
 
       // release interface
@@ -188,7 +222,10 @@ STDAPI RegisterFilters( BOOL bRegister )
 
 	if (SUCCEEDED(hr) && !bRegister)
 	{
-		hr = AMovieSetupUnregisterServer(CLSID_SpoutCam);
+		for (int i = 0; i < nCameras; i++) {
+			HRESULT hrCam = AMovieSetupUnregisterServer(*g_CamInstances[i].clsid);
+			if (i == 0) hr = hrCam;
+		}
 		hr = AMovieSetupUnregisterServer(CLSID_SpoutCamPropertyPage); //VS
 	}
 
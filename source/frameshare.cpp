@@ -0,0 +1,250 @@
+//
+//		SpoutCam - frameshare.cpp
+//
+//	Converted frame sharing between processes
+//
+//	A shared memory ring is created for each sender, frame size and
+//	pixel format. The header records the sender frame number and the
+//	conversion of each slot. The map mutex is held only to update the
+//	header. Pixels are copied without the lock while the slot is
+//	marked for writing or has readers.
+//
+//	19.10.26 - Create file
+//	19.10.26 - Write - check the claim and mark the slot for writing
+//			   under the lock before copying the pixels. A claim that
+//			   expired during conversion could be taken by another
+//			   receiver while the pixels were copied.
+//
+
+#include "frameshare.h"
+
+CFrameShare::CFrameShare()
+{
+	m_MapName[0] = 0;
+	m_Size = 0;
+	m_Claimed = -1;
+}
+
+CFrameShare::~CFrameShare()
+{
+	Close();
+}
+
+void CFrameShare::Close()
+{
+	m_Map.Close();
+	m_MapName[0] = 0;
+	m_Size = 0;
+	m_Claimed = -1;
+}
+
+//
+// Copy the pixels of a frame converted by another receiver
+//
+// If the frame is being converted by another receiver, wait for
+// a short time for it to finish. If the frame is not found, the slot
+// is claimed and the caller converts the frame and saves it with Write.
+//
+bool CFrameShare::Read(const char* sendername, uint64_t frame, DWORD conversion,
+	unsigned int width, unsigned int height, unsigned char* pixels, unsigned int size)
+{
+	m_Claimed = -1;
+
+	if (!Open(sendername, width, height, size))
+		return false;
+
+	const DWORD start = timeGetTime();
+	while (true) {
+
+		char* buffer = m_Map.Lock();
+		if (!buffer)
+			return false;
+
+		FrameShareHeader* header = (FrameShareHeader*)buffer;
+		const DWORD now = timeGetTime();
+		int index = FindSlot(header, frame, conversion);
+
+		if (index >= 0) {
+			FrameShareSlot& slot = header->slot[index];
+			if (slot.state == 2) {
+				// Converted by another receiver
+				slot.readers++;
+				slot.used = now;
+				m_Map.Unlock();
+				memcpy(pixels, buffer + sizeof(FrameShareHeader) + (size_t)index*m_Size, size);
+				if (m_Map.Lock()) {
+					slot.readers--;
+					m_Map.Unlock();
+				}
+				return true;
+			}
+			if (slot.state == 3 && now - slot.claimed < SPOUTCAM_SHARE_RELEASE) {
+				// Being written by another receiver
+				m_Map.Unlock();
+				if (now - start < SPOUTCAM_SHARE_WAIT) {
+					Sleep(1);
+					continue;
+				}
+				return false;
+			}
+			if (now - slot.claimed < SPOUTCAM_SHARE_CLAIM && now - start < SPOUTCAM_SHARE_WAIT) {
+				// Being converted by another receiver
+				m_Map.Unlock();
+				Sleep(1);
+				continue;
+			}
+			if (now - slot.claimed < SPOUTCAM_SHARE_CLAIM) {
+				// Do not wait any longer
+				// Convert without saving the result
+				m_Map.Unlock();
+				return false;
+			}
+			// The conversion was not finished
+			// Claim the slot again
+		}
+		else {
+			index = FreeSlot(header, now);
+		}
+
+		// Claim the slot for conversion by this receiver
+		if (index >= 0) {
+			FrameShareSlot& slot = header->slot[index];
+			slot.frame = frame;
+			slot.conversion = conversion;
+			slot.state = 1;
+			slot.claimed = now;
+			slot.used = now;
+			m_Claimed = index;
+		}
+		m_Map.Unlock();
+		return false;
+	}
+}
+
+//
+// Save the pixels of a frame claimed by Read
+//
+void CFrameShare::Write(const char* sendername, uint64_t frame, DWORD conversion,
+	unsigned int width, unsigned int height, const unsigned char* pixels, unsigned int size)
+{
+	if (m_Claimed < 0 || size != m_Size)
+		return;
+
+	const int index = m_Claimed;
+	m_Claimed = -1;
+
+	char* buffer = m_Map.Lock();
+	if (!buffer)
+		return;
+
+	// The claim may have expired and been taken by another receiver
+	FrameShareSlot& slot = ((FrameShareHeader*)buffer)->slot[index];
+	const DWORD now = timeGetTime();
+	if (slot.state != 1 || slot.frame != frame || slot.conversion != conversion
+		|| now - slot.claimed >= SPOUTCAM_SHARE_CLAIM) {
+		m_Map.Unlock();
+		return;
+	}
+
+	// Other receivers do not read, claim or re-use the slot while it is written
+	slot.state = 3;
+	slot.claimed = now;
+	m_Map.Unlock();
+
+	memcpy(buffer + sizeof(FrameShareHeader) + (size_t)index*m_Size, pixels, size);
+
+	if (!m_Map.Lock())
+		return;
+	if (slot.state == 3 && slot.frame == frame && slot.conversion == conversion)
+		slot.state = 2;
+	m_Map.Unlock();
+}
+
+//
+// Open or create the ring for the sender, frame size and pixel bytes
+//
+bool CFrameShare::Open(const char* sendername, unsigned int width, unsigned int height, unsigned int size)
+{
+	if (!sendername || !sendername[0] || size == 0)
+		return false;
+
+	char name[256]{};
+	sprintf_s(name, 256, "%s_SpoutCam_%ux%u_%u", sendername, width, height, size);
+	if (strcmp(name, m_MapName) == 0)
+		return true;
+
+	Close();
+
+	const size_t mapsize = sizeof(FrameShareHeader) + (size_t)SPOUTCAM_SHARE_SLOTS*size;
+	if (mapsize > INT_MAX)
+		return false;
+
+	if (m_Map.Create(name, (int)mapsize) == SPOUT_CREATE_FAILED) {
+		SpoutLogWarning("CFrameShare::Open - could not create map [%s]", name);
+		return false;
+	}
+
+	// Initialize a new map or check an existing one
+	char* buffer = m_Map.Lock();
+	if (!buffer) {
+		m_Map.Close();
+		return false;
+	}
+	FrameShareHeader* header = (FrameShareHeader*)buffer;
+	if (header->size == 0) {
+		header->size = sizeof(FrameShareHeader);
+		header->slots = SPOUTCAM_SHARE_SLOTS;
+		header->slotsize = size;
+	}
+	const bool bValid = (header->size == sizeof(FrameShareHeader)
+		&& header->slots == SPOUTCAM_SHARE_SLOTS && header->slotsize == size);
+	m_Map.Unlock();
+
+	if (!bValid) {
+		SpoutLogWarning("CFrameShare::Open - incompatible map [%s]", name);
+		m_Map.Close();
+		return false;
+	}
+
+	strcpy_s(m_MapName, 256, name);
+	m_Size = size;
+
+	return true;
+}
+
+// Slot with the frame and conversion
+int CFrameShare::FindSlot(FrameShareHeader* header, uint64_t frame, DWORD conversion)
+{
+	for (int i = 0; i < SPOUTCAM_SHARE_SLOTS; i++) {
+		const FrameShareSlot& slot = header->slot[i];
+		if (slot.state != 0 && slot.frame == frame && slot.conversion == conversion)
+			return i;
+	}
+	return -1;
+}
+
+// Empty or least recently used slot without readers or conversion
+int CFrameShare::FreeSlot(FrameShareHeader* header, DWORD now)
+{
+	int index = -1;
+	DWORD age = 0;
+	for (int i = 0; i < SPOUTCAM_SHARE_SLOTS; i++) {
+		const FrameShareSlot& slot = header->slot[i];
+		if (slot.state == 0)
+			return i;
+		// Readers or a writer of a process that closed while copying are released
+		if (slot.readers > 0 && now - slot.used < SPOUTCAM_SHARE_RELEASE)
+			continue;
+		if (slot.state == 1 && now - slot.claimed < SPOUTCAM_SHARE_CLAIM)
+			continue;
+		if (slot.state == 3 && now - slot.claimed < SPOUTCAM_SHARE_RELEASE)
+			continue;
+		if (index < 0 || now - slot.used > age) {
+			index = i;
+			age = now - slot.used;
+		}
+	}
+	if (index >= 0)
+		header->slot[index].readers = 0;
+	return index;
+}
@@ -0,0 +1,81 @@
+//
+//		SpoutCam - frameshare.h
+//
+//	Converted frame sharing between processes
+//
+//	When several applications open SpoutCam at the same time, each
+//	process receives and converts the same sender frames. The first
+//	to convert a frame saves the pixels to a shared memory ring and the
+//	others copy them, so that each frame is converted once for each
+//	size and conversion rather than once for each application.
+//
+//	19.10.26 - Create file
+//
+
+#pragma once
+
+#include "..\SpoutDX\source\SpoutDX.h"
+
+// Frames in each shared ring
+#define SPOUTCAM_SHARE_SLOTS 4
+
+// Time that a frame claimed for conversion is reserved (msec)
+#define SPOUTCAM_SHARE_CLAIM 50
+
+// Maximum wait for another process to convert a frame (msec)
+#define SPOUTCAM_SHARE_WAIT 8
+
+// Time after which a slot left by a process that closed
+// while reading or writing the pixels is used again (msec)
+#define SPOUTCAM_SHARE_RELEASE 1000
+
+// Frame details in the ring header
+struct FrameShareSlot {
+	uint64_t frame;       // Sender frame number
+	DWORD conversion;     // Conversion code (see spoutDX::ReceiveImage)
+	DWORD state;          // 0 empty, 1 converting, 2 ready, 3 writing
+	DWORD claimed;        // Time when claimed for conversion or writing (msec)
+	DWORD used;           // Time of last use (msec)
+	LONG readers;         // Number of readers copying the pixels
+	DWORD reserved;
+};
+
+// Ring header at the start of the map
+// The pixels for each slot follow the header
+struct FrameShareHeader {
+	DWORD size;           // Header size
+	DWORD slots;          // Number of slots
+	DWORD slotsize;       // Bytes for the pixels of each slot
+	DWORD reserved;
+	FrameShareSlot slot[SPOUTCAM_SHARE_SLOTS];
+};
+
+class CFrameShare : public SpoutFrameCache
+{
+
+public:
+
+	CFrameShare();
+	~CFrameShare();
+
+	// Copy the pixels of a frame converted by another receiver
+	bool Read(const char* sendername, uint64_t frame, DWORD conversion,
+		unsigned int width, unsigned int height, unsigned char* pixels, unsigned int size);
+	// Save the pixels of a frame claimed by Read
+	void Write(const char* sendername, uint64_t frame, DWORD conversion,
+		unsigned int width, unsigned int height, const unsigned char* pixels, unsigned int size);
+	// Close the shared ring
+	void Close();
+
+private:
+
+	bool Open(const char* sendername, unsigned int width, unsigned int height, unsigned int size);
+	int FindSlot(FrameShareHeader* header, uint64_t frame, DWORD conversion);
+	int FreeSlot(FrameShareHeader* header, DWORD now);
+
+	SpoutSharedMemory m_Map;
+	char m_MapName[256];  // Sender name, frame size and pixel bytes
+	unsigned int m_Size;  // Bytes for the pixels of each slot
+	int m_Claimed;        // Slot claimed for conversion by this receiver
+
+};
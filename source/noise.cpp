@@ -0,0 +1,145 @@
+//
+//		SpoutCam - noise.cpp
+//
+//	Static image shown when there is no sender
+//
+//	Based on Marsaglia's xorshift generator (http://www.jstatsoft.org/v08/i14/paper)
+//	as previously used by cam.cpp (https://excamera.com/sphinx/article-xorshift.html).
+//	Each 32 bit lane is an independent generator with the shifts 13, 17, 5.
+//
+//	19.10.26 - Create file
+//	19.10.26 - Seed each lane with splitmix64 of the seed and lane index.
+//			   Lanes seeded from consecutive outputs of one xorshift were
+//			   the same sequence one step apart, so each 64 byte block was
+//			   the previous block shifted by 4 bytes.
+//
+
+#include "noise.h"
+
+//
+// splitmix64 (Steele, Lea and Flood) for lane seeds
+//
+// Consecutive inputs give unrelated outputs, so lanes seeded
+// from the lane index are not steps of the same sequence.
+//
+static uint64_t SplitMix64(uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30))*0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27))*0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+CStaticNoise::CStaticNoise()
+{
+	m_Seed = 7; // 100% random seed value
+	m_PoolSize = 0;
+	m_PoolFrame = 0;
+	// An independent non-zero seed for each lane
+	uint32_t seeds[16];
+	for (int lane = 0; lane < 16; lane++) {
+		uint32_t s = (uint32_t)SplitMix64(((uint64_t)m_Seed << 32) | (uint64_t)lane);
+		if (s == 0) s = 0x6D2B79F5; // xorshift state must not be zero
+		seeds[lane] = s;
+	}
+	for (int i = 0; i < 4; i++)
+		m_State[i] = _mm_setr_epi32((int)seeds[i*4], (int)seeds[i*4 + 1],
+			(int)seeds[i*4 + 2], (int)seeds[i*4 + 3]);
+}
+
+//
+// Fill a buffer with new noise
+//
+void CStaticNoise::Fill(BYTE* data, long size)
+{
+	if (!data || size <= 0)
+		return;
+	Generate(data, (size_t)size);
+}
+
+//
+// Copy noise from the pool
+//
+// The pool is generated again if the size changes. Frames are used in turn,
+// each from a random offset, so that the static does not repeat visibly.
+//
+void CStaticNoise::FillFromPool(BYTE* data, long size)
+{
+	if (!data || size <= 0)
+		return;
+
+	if (m_PoolSize != (size_t)size) {
+		m_PoolSize = (size_t)size;
+		m_Pool.resize(m_PoolSize*SPOUTCAM_NOISE_FRAMES + SPOUTCAM_NOISE_OFFSETS);
+		Generate(m_Pool.data(), m_Pool.size());
+	}
+
+	const size_t offset = Next() % SPOUTCAM_NOISE_OFFSETS;
+	memcpy(data, m_Pool.data() + m_PoolFrame*m_PoolSize + offset, m_PoolSize);
+	m_PoolFrame = (m_PoolFrame + 1) % SPOUTCAM_NOISE_FRAMES;
+}
+
+//
+// Free the pool
+//
+void CStaticNoise::Release()
+{
+	if (m_Pool.empty())
+		return;
+	std::vector<BYTE>().swap(m_Pool);
+	m_PoolSize = 0;
+	m_PoolFrame = 0;
+}
+
+//
+// Scalar xorshift for seeds and offsets
+//
+uint32_t CStaticNoise::Next()
+{
+	m_Seed ^= m_Seed << 13;
+	m_Seed ^= m_Seed >> 17;
+	m_Seed ^= m_Seed << 5;
+	return m_Seed;
+}
+
+//
+// Noise 64 bytes at a time from four registers of generators
+//
+void CStaticNoise::Generate(BYTE* data, size_t size)
+{
+	__m128i s0 = m_State[0];
+	__m128i s1 = m_State[1];
+	__m128i s2 = m_State[2];
+	__m128i s3 = m_State[3];
+
+	auto Step = [](__m128i s) {
+		s = _mm_xor_si128(s, _mm_slli_epi32(s, 13));
+		s = _mm_xor_si128(s, _mm_srli_epi32(s, 17));
+		return _mm_xor_si128(s, _mm_slli_epi32(s, 5));
+	};
+
+	size_t i = 0;
+	for (; i + 64 <= size; i += 64) {
+		s0 = Step(s0);
+		s1 = Step(s1);
+		s2 = Step(s2);
+		s3 = Step(s3);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), s0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + i + 16), s1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + i + 32), s2);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + i + 48), s3);
+	}
+
+	// Remaining bytes
+	for (; i < size; i += 16) {
+		s0 = Step(s0);
+		alignas(16) BYTE bytes[16];
+		_mm_store_si128(reinterpret_cast<__m128i*>(bytes), s0);
+		memcpy(data + i, bytes, (size - i < 16) ? (size - i) : 16);
+	}
+
+	m_State[0] = s0;
+	m_State[1] = s1;
+	m_State[2] = s2;
+	m_State[3] = s3;
+}
@@ -0,0 +1,51 @@
+//
+//		SpoutCam - noise.h
+//
+//	Static image shown when there is no sender
+//
+//	Noise is generated by sixteen xorshift generators held in four
+//	SSE2 registers, so that each step writes 64 bytes instead of one.
+//	Pool mode generates a few frames of noise once and copies one of
+//	them from a random offset for each frame, so that the static image
+//	costs one copy of the frame.
+//
+//	19.10.26 - Create file
+//
+
+#pragma once
+
+#include "..\SpoutDX\source\SpoutDX.h"
+#include <vector>
+
+// Frames of noise in the pool
+#define SPOUTCAM_NOISE_FRAMES 3
+
+// Range of the random offset into each pool frame (bytes)
+#define SPOUTCAM_NOISE_OFFSETS 65536
+
+class CStaticNoise
+{
+
+public:
+
+	CStaticNoise();
+
+	// Fill a buffer with new noise
+	void Fill(BYTE* data, long size);
+	// Copy noise from the pool, generated for a new size
+	void FillFromPool(BYTE* data, long size);
+	// Free the pool
+	void Release();
+
+private:
+
+	uint32_t Next();
+	void Generate(BYTE* data, size_t size);
+
+	__m128i m_State[4];       // Generator state, four 32 bit lanes in each
+	uint32_t m_Seed;          // Scalar generator for seeds and offsets
+	std::vector<BYTE> m_Pool; // Frames of noise with room for the offset
+	size_t m_PoolSize;        // Frame size of the pool
+	unsigned int m_PoolFrame; // Next frame of the pool
+
+};
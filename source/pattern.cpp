@@ -0,0 +1,303 @@
+//
+//		SpoutCam - pattern.cpp
+//
+//	Test patterns shown when there is no sender
+//
+//	Colour bars follow the layout of SMPTE EG 1 with 75% bars and
+//	full range RGB values. The moving bar steps one bar width for each
+//	frame, so that a frame can be identified by the bar position as
+//	well as by the frame number.
+//
+//	19.10.26 - Create file
+//
+
+#include "pattern.h"
+#include <stdio.h>
+
+// 5 x 7 font for the digits, ':' and '.'
+// Each row is 5 bits, the left pixel in bit 4
+static const BYTE PatternFont[12][7] = {
+	{ 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // 0
+	{ 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 1
+	{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // 2
+	{ 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // 3
+	{ 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // 4
+	{ 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // 5
+	{ 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // 6
+	{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // 7
+	{ 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // 8
+	{ 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // 9
+	{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // :
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // .
+};
+
+// Sweep colours
+#define PATTERN_BACKGROUND 0x202020
+#define PATTERN_GRID       0x404040
+#define PATTERN_BAR        0xFFFFFF
+#define PATTERN_TEXT       0xFFFFFF
+#define PATTERN_TEXTBOX    0x000000
+
+CTestPattern::CTestPattern()
+{
+	m_Width = 0;
+	m_Height = 0;
+	m_Bpp = 0;
+	m_Pitch = 0;
+	m_bInvert = false;
+	m_Pattern = SPOUTCAM_PATTERN_NONE;
+	m_BarWidth = 0;
+	m_BarHeight = 0;
+	m_Scale = 1;
+	m_bText = false;
+	m_NextBuffer = 0;
+	Reset();
+}
+
+//
+// Forget the contents of the sample buffers
+//
+// Called when a sample buffer has been written with anything other
+// than the pattern, so that the next pattern frame is drawn in full.
+//
+void CTestPattern::Reset()
+{
+	for (unsigned int i = 0; i < SPOUTCAM_PATTERN_BUFFERS; i++)
+		m_Buffers[i].data = nullptr;
+}
+
+//
+// Draw a pattern into a sample buffer
+//
+// A buffer that is not one of the last drawn is copied in full from the
+// fixed part. Otherwise only the bar and the changed digits are drawn.
+//
+bool CTestPattern::Draw(BYTE* data, long size, unsigned int width, unsigned int height,
+	unsigned int bpp, bool bInvert, int pattern, long long frame, long long time)
+{
+	if (!data || width == 0 || height == 0 || (bpp != 3 && bpp != 4)
+		|| pattern <= SPOUTCAM_PATTERN_NONE || pattern > SPOUTCAM_PATTERN_SWEEP)
+		return false;
+
+	// Rows of Windows bitmaps are a multiple of 4 bytes
+	const unsigned int pitch = ((width*bpp + 3)/4)*4;
+	if (size < (long)(pitch*height))
+		return false;
+
+	// Draw the fixed part for a new size or pattern
+	if (width != m_Width || height != m_Height || bpp != m_Bpp
+		|| bInvert != m_bInvert || pattern != m_Pattern) {
+		m_Width = width;
+		m_Height = height;
+		m_Bpp = bpp;
+		m_Pitch = pitch;
+		m_bInvert = bInvert;
+		m_Pattern = pattern;
+		DrawBase();
+		Reset();
+	}
+
+	// Find the buffer
+	PatternBuffer* buffer = nullptr;
+	for (unsigned int i = 0; i < SPOUTCAM_PATTERN_BUFFERS; i++) {
+		if (m_Buffers[i].data == data)
+			buffer = &m_Buffers[i];
+	}
+	if (!buffer) {
+		buffer = &m_Buffers[m_NextBuffer];
+		m_NextBuffer = (m_NextBuffer + 1) % SPOUTCAM_PATTERN_BUFFERS;
+		memcpy(data, m_Base.data(), m_Base.size());
+		buffer->data = data;
+		buffer->bar = m_Width; // no bar
+		buffer->text[0][0] = 0;
+		buffer->text[1][0] = 0;
+	}
+
+	if (m_Pattern != SPOUTCAM_PATTERN_SWEEP)
+		return true;
+
+	// Bar one bar width further for each frame
+	const unsigned int steps = m_Width/m_BarWidth;
+	const unsigned int bar = (unsigned int)(frame % steps)*m_BarWidth;
+	if (bar != buffer->bar) {
+		if (buffer->bar < m_Width)
+			Restore(data, buffer->bar, 0, m_BarWidth, m_BarHeight);
+		Fill(data, bar, 0, m_BarWidth, m_BarHeight, PATTERN_BAR);
+		buffer->bar = bar;
+	}
+
+	// Frame number and stream time hh:mm:ss.mmm
+	if (m_bText) {
+		char text[2][16]{};
+		sprintf_s(text[0], 16, "%010lld", frame % 10000000000LL);
+		const long long msec = time/10000LL;
+		sprintf_s(text[1], 16, "%02lld:%02lld:%02lld.%03lld",
+			(msec/3600000LL) % 100LL, (msec/60000LL) % 60LL, (msec/1000LL) % 60LL, msec % 1000LL);
+		for (unsigned int line = 0; line < 2; line++) {
+			DrawText(data, line, text[line], buffer->text[line]);
+			strcpy_s(buffer->text[line], 16, text[line]);
+		}
+	}
+
+	return true;
+}
+
+//
+// Draw the fixed part of the pattern
+//
+void CTestPattern::DrawBase()
+{
+	m_Base.resize((size_t)m_Pitch*m_Height);
+	memset(m_Base.data(), 0, m_Base.size());
+	BYTE* data = m_Base.data();
+	const unsigned int w = m_Width;
+	const unsigned int h = m_Height;
+
+	if (m_Pattern == SPOUTCAM_PATTERN_BARS) {
+		// 75% bars : grey, yellow, cyan, green, magenta, red, blue
+		static const DWORD bars[7] = { 0xBFBFBF, 0xBFBF00, 0x00BFBF, 0x00BF00, 0xBF00BF, 0xBF0000, 0x0000BF };
+		// Reverse bars : blue, black, magenta, black, cyan, black, grey
+		static const DWORD reverse[7] = { 0x0000BF, 0x000000, 0xBF00BF, 0x000000, 0x00BFBF, 0x000000, 0xBFBFBF };
+		// -I, white, +Q, black
+		static const DWORD lower[4] = { 0x00214C, 0xFFFFFF, 0x32006A, 0x000000 };
+		// PLUGE : -4% (clipped), black, +4%
+		static const DWORD pluge[3] = { 0x000000, 0x000000, 0x0A0A0A };
+		const unsigned int y1 = h*2/3;
+		const unsigned int y2 = h*3/4;
+		for (unsigned int i = 0; i < 7; i++) {
+			const unsigned int x0 = w*i/7;
+			const unsigned int x1 = w*(i + 1)/7;
+			Fill(data, x0, 0, x1 - x0, y1, bars[i]);
+			Fill(data, x0, y1, x1 - x0, y2 - y1, reverse[i]);
+		}
+		for (unsigned int i = 0; i < 4; i++) {
+			const unsigned int x0 = w*i*5/28;
+			const unsigned int x1 = w*(i + 1)*5/28;
+			Fill(data, x0, y2, x1 - x0, h - y2, lower[i]);
+		}
+		for (unsigned int i = 0; i < 3; i++) {
+			const unsigned int x0 = w*5/7 + w*i/21;
+			const unsigned int x1 = w*5/7 + w*(i + 1)/21;
+			Fill(data, x0, y2, x1 - x0, h - y2, pluge[i]);
+		}
+	}
+	else if (m_Pattern == SPOUTCAM_PATTERN_RAMP) {
+		// Grey, red, green and blue bands from 0 at the left to 255 at the right
+		static const DWORD ramps[4] = { 0xFFFFFF, 0xFF0000, 0x00FF00, 0x0000FF };
+		for (unsigned int i = 0; i < 4; i++) {
+			const unsigned int y0 = h*i/4;
+			const unsigned int y1 = h*(i + 1)/4;
+			for (unsigned int x = 0; x < w; x++) {
+				const DWORD v = (w > 1) ? (DWORD)(x*255/(w - 1)) : 255;
+				const DWORD rgb = ((ramps[i] >> 16 & 0xFF)*v/255) << 16
+					| ((ramps[i] >> 8 & 0xFF)*v/255) << 8 | ((ramps[i] & 0xFF)*v/255);
+				Fill(data, x, y0, 1, y1 - y0, rgb);
+			}
+		}
+	}
+	else {
+		// Text of two lines of 7 points with a gap of 1 point
+		// below the bar, 1/180 of the height for each point
+		m_Scale = (h >= 180) ? h/180 : 1;
+		const unsigned int textheight = 17*m_Scale;
+		m_bText = (h > textheight*2 && w >= (12*6 + 1)*m_Scale);
+		m_BarHeight = m_bText ? (h - textheight) : h;
+		m_BarWidth = (w >= 64) ? w/64 : 1;
+
+		// Background with a grid of 16 columns
+		Fill(data, 0, 0, w, m_BarHeight, PATTERN_BACKGROUND);
+		for (unsigned int i = 0; i < 16; i++)
+			Fill(data, w*i/16, 0, 1, m_BarHeight, PATTERN_GRID);
+		if (m_bText)
+			Fill(data, 0, m_BarHeight, w, h - m_BarHeight, PATTERN_TEXTBOX);
+	}
+}
+
+//
+// Row y from the top
+//
+BYTE* CTestPattern::Row(BYTE* data, unsigned int y)
+{
+	return data + (size_t)(m_bInvert ? (m_Height - y - 1) : y)*m_Pitch;
+}
+
+//
+// Fill a rectangle with a colour (0xRRGGBB)
+//
+void CTestPattern::Fill(BYTE* data, unsigned int x, unsigned int y, unsigned int w, unsigned int h, DWORD rgb)
+{
+	if (x >= m_Width || y >= m_Height)
+		return;
+	if (w > m_Width - x) w = m_Width - x;
+	if (h > m_Height - y) h = m_Height - y;
+
+	const BYTE pixel[4] = { (BYTE)(rgb & 0xFF), (BYTE)(rgb >> 8 & 0xFF), (BYTE)(rgb >> 16 & 0xFF), 0xFF };
+	for (unsigned int i = 0; i < h; i++) {
+		BYTE* row = Row(data, y + i) + (size_t)x*m_Bpp;
+		// First pixel, then copy doubling lengths of the row
+		memcpy(row, pixel, m_Bpp);
+		size_t done = m_Bpp;
+		const size_t bytes = (size_t)w*m_Bpp;
+		while (done < bytes) {
+			const size_t n = (done < bytes - done) ? done : (bytes - done);
+			memcpy(row + done, row, n);
+			done += n;
+		}
+	}
+}
+
+//
+// Copy a rectangle from the fixed part
+//
+void CTestPattern::Restore(BYTE* data, unsigned int x, unsigned int y, unsigned int w, unsigned int h)
+{
+	if (x >= m_Width || y >= m_Height)
+		return;
+	if (w > m_Width - x) w = m_Width - x;
+	if (h > m_Height - y) h = m_Height - y;
+
+	for (unsigned int i = 0; i < h; i++) {
+		const size_t offset = (size_t)(Row(data, y + i) - data) + (size_t)x*m_Bpp;
+		memcpy(data + offset, m_Base.data() + offset, (size_t)w*m_Bpp);
+	}
+}
+
+//
+// Draw one character cell of 6 x 8 points at x, y
+//
+void CTestPattern::DrawChar(BYTE* data, unsigned int x, unsigned int y, char c)
+{
+	const unsigned int s = m_Scale;
+	Fill(data, x, y, 6*s, 8*s, PATTERN_TEXTBOX);
+
+	int glyph = -1;
+	if (c >= '0' && c <= '9') glyph = c - '0';
+	else if (c == ':') glyph = 10;
+	else if (c == '.') glyph = 11;
+	if (glyph < 0)
+		return;
+
+	for (unsigned int row = 0; row < 7; row++) {
+		const BYTE bits = PatternFont[glyph][row];
+		for (unsigned int col = 0; col < 5; col++) {
+			if (bits & (0x10 >> col))
+				Fill(data, x + col*s, y + row*s, s, s, PATTERN_TEXT);
+		}
+	}
+}
+
+//
+// Draw the characters of a text line that differ from the previous text
+//
+void CTestPattern::DrawText(BYTE* data, unsigned int line, const char* text, const char* previous)
+{
+	const unsigned int s = m_Scale;
+	const unsigned int y = m_BarHeight + s + line*8*s;
+	bool bEnd = false; // End of the previous text
+	for (unsigned int i = 0; text[i]; i++) {
+		if (!bEnd && previous[i] == 0)
+			bEnd = true;
+		if (bEnd || previous[i] != text[i])
+			DrawChar(data, s + i*6*s, y, text[i]);
+	}
+}
@@ -0,0 +1,76 @@
+//
+//		SpoutCam - pattern.h
+//
+//	Test patterns shown when there is no sender
+//
+//	SMPTE colour bars, grey and colour ramps, or a moving bar with the
+//	frame number and stream time, for checking the output of downstream
+//	applications. The fixed part of a pattern is drawn once for each
+//	size and pattern. For each frame, only the bar and the digits that
+//	have changed since a sample buffer was last drawn are drawn again.
+//
+//	19.10.26 - Create file
+//
+
+#pragma once
+
+#include <windows.h>
+#include <vector>
+
+// Patterns
+#define SPOUTCAM_PATTERN_NONE  0 // Static noise
+#define SPOUTCAM_PATTERN_BARS  1 // SMPTE colour bars
+#define SPOUTCAM_PATTERN_RAMP  2 // Grey, red, green and blue ramps
+#define SPOUTCAM_PATTERN_SWEEP 3 // Moving bar, frame number and time
+
+// Sample buffers with known contents
+#define SPOUTCAM_PATTERN_BUFFERS 4
+
+class CTestPattern
+{
+
+public:
+
+	CTestPattern();
+
+	// Draw a pattern into a sample buffer of RGB (bpp 3) or RGBX (bpp 4)
+	// pixels in Windows bitmap order (BGR). Rows are bottom up if inverted.
+	// frame and time (100 nsec units) are shown by SPOUTCAM_PATTERN_SWEEP.
+	bool Draw(BYTE* data, long size, unsigned int width, unsigned int height,
+		unsigned int bpp, bool bInvert, int pattern, long long frame, long long time);
+	// Forget the contents of sample buffers written by others
+	void Reset();
+
+private:
+
+	struct PatternBuffer {
+		BYTE* data;          // Sample buffer
+		unsigned int bar;    // Bar position drawn
+		char text[2][16];    // Text drawn
+	};
+
+	void DrawBase();
+	BYTE* Row(BYTE* data, unsigned int y);
+	void Fill(BYTE* data, unsigned int x, unsigned int y, unsigned int w, unsigned int h, DWORD rgb);
+	void Restore(BYTE* data, unsigned int x, unsigned int y, unsigned int w, unsigned int h);
+	void DrawChar(BYTE* data, unsigned int x, unsigned int y, char c);
+	void DrawText(BYTE* data, unsigned int line, const char* text, const char* previous);
+
+	std::vector<BYTE> m_Base;  // Fixed part of the pattern
+	unsigned int m_Width;
+	unsigned int m_Height;
+	unsigned int m_Bpp;
+	unsigned int m_Pitch;
+	bool m_bInvert;
+	int m_Pattern;
+
+	// Layout of SPOUTCAM_PATTERN_SWEEP
+	unsigned int m_BarWidth;   // Width of the moving bar
+	unsigned int m_BarHeight;  // Rows above the text
+	unsigned int m_Scale;      // Pixels for each point of the font
+	bool m_bText;              // Room for the text
+
+	PatternBuffer m_Buffers[SPOUTCAM_PATTERN_BUFFERS];
+	unsigned int m_NextBuffer;
+
+};
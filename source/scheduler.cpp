@@ -0,0 +1,183 @@
+//
+//		SpoutCam - scheduler.cpp
+//
+//	Pixel conversion scheduler
+//
+//	The worker threads are started when the first filter is created
+//	and stopped when the last filter is released, so that no thread
+//	is running when the module is unloaded.
+//
+//	19.10.26 - Create file
+//	19.10.26 - Detach worker threads still running when the scheduler is destroyed
+//
+
+#include "scheduler.h"
+
+CConvertScheduler& CConvertScheduler::Get()
+{
+	static CConvertScheduler scheduler;
+	return scheduler;
+}
+
+CConvertScheduler::CConvertScheduler()
+{
+	m_Sequence = 0;
+	m_Clients = 0;
+	m_bStop = false;
+}
+
+CConvertScheduler::~CConvertScheduler()
+{
+	// Threads are stopped by the last client. If the host exits without
+	// releasing the filters, this runs at DLL_PROCESS_DETACH after the
+	// worker threads have been ended by the system. Joinable threads
+	// would then call std::terminate when the vector is destroyed.
+	// The lock is not taken because an ended thread could hold it.
+	for (auto& thread : m_Threads) {
+		if (thread.joinable())
+			thread.detach();
+	}
+}
+
+void CConvertScheduler::AddClient()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	if (m_Clients++ > 0)
+		return;
+
+	// One thread for each core except the one used by the streaming thread
+	int nThreads = (int)std::thread::hardware_concurrency() - 1;
+	if (nThreads > SPOUTCAM_MAX_WORKERS) nThreads = SPOUTCAM_MAX_WORKERS;
+	m_bStop = false;
+	for (int i = 0; i < nThreads; i++)
+		m_Threads.push_back(std::thread(&CConvertScheduler::Worker, this));
+}
+
+void CConvertScheduler::RemoveClient()
+{
+	std::vector<std::thread> threads;
+	{
+		std::lock_guard<std::mutex> lock(m_Lock);
+		if (m_Clients == 0 || --m_Clients > 0)
+			return;
+		m_bStop = true;
+		threads.swap(m_Threads);
+	}
+	m_Work.notify_all();
+	for (auto& thread : threads)
+		thread.join();
+}
+
+//
+// Run a conversion in bands of rows
+//
+// The calling thread runs bands of its own job while the workers
+// take bands from all jobs in order of deadline. The call returns
+// when every band of the job is complete.
+//
+void CConvertScheduler::Run(std::chrono::steady_clock::time_point deadline, unsigned int rows,
+	const std::function<void(unsigned int, unsigned int)>& func)
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+
+	// Small frames or no workers
+	if (m_Threads.empty() || rows < SPOUTCAM_BAND_ROWS*2) {
+		lock.unlock();
+		func(0, rows);
+		return;
+	}
+
+	// Two bands for each thread including the caller
+	unsigned int bands = (unsigned int)(m_Threads.size() + 1) * 2;
+	if (bands > rows / SPOUTCAM_BAND_ROWS)
+		bands = rows / SPOUTCAM_BAND_ROWS;
+
+	Job job{};
+	job.deadline = deadline;
+	job.sequence = m_Sequence++;
+	job.func = &func;
+	job.rows = rows;
+	job.band = (rows + bands - 1) / bands;
+	job.bands = (rows + job.band - 1) / job.band;
+	m_Jobs.push_back(&job);
+	m_Work.notify_all();
+
+	while (job.next < job.bands) {
+		const unsigned int index = job.next++;
+		if (job.next == job.bands)
+			m_Jobs.erase(std::find(m_Jobs.begin(), m_Jobs.end(), &job));
+		lock.unlock();
+		RunBand(&job, index);
+		lock.lock();
+		job.done++;
+	}
+
+	// Wait for bands run by the workers
+	m_Done.wait(lock, [&job] { return job.done == job.bands; });
+}
+
+void CConvertScheduler::Worker()
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+	while (true) {
+		m_Work.wait(lock, [this] { return m_bStop || !m_Jobs.empty(); });
+		if (m_bStop)
+			break;
+
+		Job* job = NextJob();
+		const unsigned int index = job->next++;
+		if (job->next == job->bands)
+			m_Jobs.erase(std::find(m_Jobs.begin(), m_Jobs.end(), job));
+		lock.unlock();
+		RunBand(job, index);
+		lock.lock();
+		if (++job->done == job->bands)
+			m_Done.notify_all();
+	}
+}
+
+// The job with the earliest deadline, then the first submitted
+CConvertScheduler::Job* CConvertScheduler::NextJob()
+{
+	Job* next = m_Jobs[0];
+	for (Job* job : m_Jobs) {
+		if (job->deadline < next->deadline
+			|| (job->deadline == next->deadline && job->sequence < next->sequence))
+			next = job;
+	}
+	return next;
+}
+
+void CConvertScheduler::RunBand(Job* job, unsigned int index)
+{
+	const unsigned int y0 = index * job->band;
+	unsigned int y1 = y0 + job->band;
+	if (y1 > job->rows) y1 = job->rows;
+	(*job->func)(y0, y1);
+}
+
+//
+// Row scheduler for one filter
+//
+
+CConvertClient::CConvertClient()
+{
+	m_Deadline = std::chrono::steady_clock::now();
+	CConvertScheduler::Get().AddClient();
+}
+
+CConvertClient::~CConvertClient()
+{
+	CConvertScheduler::Get().RemoveClient();
+}
+
+// Deadline for the conversions of the current frame
+void CConvertClient::SetDeadline(std::chrono::steady_clock::time_point deadline)
+{
+	m_Deadline = deadline;
+}
+
+void CConvertClient::Run(unsigned int rows, const std::function<void(unsigned int, unsigned int)>& func)
+{
+	CConvertScheduler::Get().Run(m_Deadline, rows, func);
+}
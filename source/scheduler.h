@@ -0,0 +1,100 @@
+//
+//		SpoutCam - scheduler.h
+//
+//	Pixel conversion scheduler
+//
+//	One scheduler is shared by all SpoutCam filters in a process.
+//	Each filter divides a frame conversion into bands of rows which are
+//	run by a pool of worker threads and by the filter streaming thread.
+//	Bands are taken from the frame with the earliest deadline first,
+//	so that filters with different frame rates share the cores fairly.
+//
+//	19.10.26 - Create file
+//
+
+#pragma once
+
+#include "..\SpoutDX\source\SpoutDX.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+// Minimum rows for each band
+#define SPOUTCAM_BAND_ROWS 32
+
+// Maximum number of worker threads
+#define SPOUTCAM_MAX_WORKERS 7
+
+class CConvertScheduler
+{
+
+public:
+
+	// The scheduler for this process
+	static CConvertScheduler& Get();
+
+	// Worker threads are started with the first client and stopped with the last
+	void AddClient();
+	void RemoveClient();
+
+	// Run a conversion in bands of rows and return when all are complete
+	void Run(std::chrono::steady_clock::time_point deadline, unsigned int rows,
+		const std::function<void(unsigned int, unsigned int)>& func);
+
+private:
+
+	struct Job {
+		std::chrono::steady_clock::time_point deadline; // Frame deadline of the client
+		unsigned long long sequence; // Submission order for equal deadlines
+		const std::function<void(unsigned int, unsigned int)>* func;
+		unsigned int rows;  // Total rows
+		unsigned int band;  // Rows for each band
+		unsigned int bands; // Number of bands
+		unsigned int next;  // Next band to start
+		unsigned int done;  // Bands completed
+	};
+
+	CConvertScheduler();
+	~CConvertScheduler();
+
+	void Worker();
+	Job* NextJob();
+	void RunBand(Job* job, unsigned int index);
+
+	std::mutex m_Lock;
+	std::condition_variable m_Work; // Jobs waiting or stop
+	std::condition_variable m_Done; // Job completed
+	std::vector<Job*> m_Jobs;       // Jobs with bands not yet started
+	std::vector<std::thread> m_Threads;
+	unsigned long long m_Sequence;
+	int m_Clients;
+	bool m_bStop;
+
+};
+
+//
+// Row scheduler for one filter
+//
+// Set to the filter receiver (spoutDX::SetRowScheduler).
+// The filter sets a deadline for each frame.
+//
+class CConvertClient : public SpoutRowScheduler
+{
+
+public:
+
+	CConvertClient();
+	~CConvertClient();
+
+	void SetDeadline(std::chrono::steady_clock::time_point deadline);
+	void Run(unsigned int rows, const std::function<void(unsigned int, unsigned int)>& func);
+
+private:
+
+	std::chrono::steady_clock::time_point m_Deadline;
+
+};
@@ -0,0 +1,266 @@
+//
+//		SpoutCam - settings.cpp
+//
+//	Settings service
+//
+//	Settings are read from the registry once when the filter starts
+//	and again only when the registry key changes. The streaming thread
+//	does not read or write the registry.
+//
+//	19.10.26 - Create file
+//
+
+#include "cam.h"
+
+CCamSettingsService::CCamSettingsService()
+{
+	m_Key[0] = 0;
+	m_SenderName[0] = 0;
+	m_Version = 0;
+	m_hStop = NULL;
+	m_hWrite = NULL;
+}
+
+CCamSettingsService::~CCamSettingsService()
+{
+	Stop();
+}
+
+//
+// Load settings from the registry and start watching for changes
+//
+// The first snapshot is loaded before return so that it is
+// available to the filter constructor.
+//
+bool CCamSettingsService::Start(const char* key)
+{
+	if (m_Thread.joinable())
+		return true;
+
+	strcpy_s(m_Key, 256, key);
+
+	std::shared_ptr<CamSettings> pSettings = std::make_shared<CamSettings>();
+	Load(*pSettings);
+	std::atomic_store(&m_pSettings, std::shared_ptr<const CamSettings>(pSettings));
+	m_Version++;
+
+	m_hStop = CreateEventA(NULL, TRUE, FALSE, NULL);
+	m_hWrite = CreateEventA(NULL, FALSE, FALSE, NULL);
+	if (!m_hStop || !m_hWrite) {
+		SpoutLogWarning("CCamSettingsService::Start - could not create events");
+		Stop();
+		return false;
+	}
+
+	m_Thread = std::thread(&CCamSettingsService::Watch, this);
+
+	return true;
+}
+
+//
+// Stop watching for changes
+//
+// A sender name waiting to be written is written before the thread exits.
+//
+void CCamSettingsService::Stop()
+{
+	if (m_Thread.joinable()) {
+		SetEvent(m_hStop);
+		m_Thread.join();
+	}
+	if (m_hStop) CloseHandle(m_hStop);
+	if (m_hWrite) CloseHandle(m_hWrite);
+	m_hStop = NULL;
+	m_hWrite = NULL;
+}
+
+//
+// The current settings snapshot
+//
+// A snapshot is not changed after it is created. The caller can keep
+// the pointer for as long as needed and check GetVersion for changes.
+//
+std::shared_ptr<const CamSettings> CCamSettingsService::Get() const
+{
+	std::shared_ptr<const CamSettings> pSettings = std::atomic_load(&m_pSettings);
+	if (!pSettings)
+		pSettings = std::make_shared<const CamSettings>(CamSettings{ 3, 0 });
+	return pSettings;
+}
+
+LONG CCamSettingsService::GetVersion() const
+{
+	return m_Version.load(std::memory_order_acquire);
+}
+
+//
+// Write the received sender name to the registry for SpoutCamSettings
+//
+// The name is copied and written by the watcher thread.
+// Only the latest name is written if there are several changes.
+//
+void CCamSettingsService::WriteSenderName(const char* name)
+{
+	if (!name)
+		return;
+
+	if (!m_Thread.joinable()) {
+		WritePathToRegistry(HKEY_CURRENT_USER, m_Key, "sendername", name);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_WriteLock);
+		strcpy_s(m_SenderName, 256, name);
+	}
+	SetEvent(m_hWrite);
+}
+
+//
+// Read all settings from the registry
+//
+void CCamSettingsService::Load(CamSettings& settings)
+{
+	memset(&settings, 0, sizeof(CamSettings));
+
+	//
+	// Fps and resolution from SpoutCamSettings
+	//		o Fps
+	//			10	0
+	//			15	1
+	//			25	2
+	//			30	3 (default)
+	// Compatibility problems with some software if > 60 fps
+	//			50	4
+	//			60	5
+	//
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "fps", &settings.dwFps))
+		settings.dwFps = 3;
+
+	//		o Resolution
+	//			Sender			0 (default)
+	//			320 x 240		1
+	//			640 x 360		2
+	//			640 x 480		3 (default if no sender)
+	//			800 x 600		4
+	//			1024 x 720		5
+	//			1024 x 768		6
+	//			1280 x 720		7
+	//			1280 x 960		8
+	//			1280 x 1024		9
+	//			1920 x 1080		10
+	//
+	if (!ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "resolution", &settings.dwResolution))
+		settings.dwResolution = 0;
+
+	// Options
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "mirror", &settings.dwMirror);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "swap", &settings.dwSwap);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "flip", &settings.dwFlip);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "rotation", &settings.dwRotation);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "framewait", &settings.dwFrameWait);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "timing", &settings.dwTiming);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "frameshare", &settings.dwFrameShare);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "changedetect", &settings.dwChangeDetect);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "fitmode", &settings.dwFitMode);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "bordercolour", &settings.dwBorderColour);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "regionx", &settings.dwRegionX);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "regiony", &settings.dwRegionY);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "regionwidth", &settings.dwRegionWidth);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "regionheight", &settings.dwRegionHeight);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "tonemap", &settings.dwToneMap);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "exposure", &settings.dwExposure);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "brightness", &settings.dwBrightness);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "contrast", &settings.dwContrast);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "gamma", &settings.dwGamma);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "saturation", &settings.dwSaturation);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "blacklevel", &settings.dwBlackLevel);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "whitelevel", &settings.dwWhiteLevel);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "staticmode", &settings.dwStaticMode);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "pattern", &settings.dwPattern);
+	ReadDwordFromRegistry(HKEY_CURRENT_USER, m_Key, "timecode", &settings.dwTimecode);
+
+	// Starting sender name
+	ReadPathFromRegistry(HKEY_CURRENT_USER, m_Key, "senderstart", settings.senderstart, 256);
+}
+
+//
+// Replace the snapshot if any setting has changed
+//
+// Writing "sendername" also signals a change of the key,
+// but does not affect the snapshot.
+//
+void CCamSettingsService::Reload()
+{
+	std::shared_ptr<CamSettings> pSettings = std::make_shared<CamSettings>();
+	Load(*pSettings);
+
+	std::shared_ptr<const CamSettings> pCurrent = std::atomic_load(&m_pSettings);
+	if (pCurrent && memcmp(pCurrent.get(), pSettings.get(), sizeof(CamSettings)) == 0)
+		return;
+
+	std::atomic_store(&m_pSettings, std::shared_ptr<const CamSettings>(pSettings));
+	m_Version.fetch_add(1, std::memory_order_release);
+	SpoutLogNotice("SpoutCam settings changed");
+}
+
+//
+// Watcher thread
+//
+// RegNotifyChangeKeyValue signals once for each registration, so the
+// notification is made again before the settings are read to avoid
+// missing a change. The registration ends when the thread exits.
+//
+void CCamSettingsService::Watch()
+{
+	HKEY hKey = NULL;
+	HANDLE hChange = CreateEventA(NULL, FALSE, FALSE, NULL);
+	if (hChange) {
+		if (RegCreateKeyExA(HKEY_CURRENT_USER, m_Key, 0, NULL, REG_OPTION_NON_VOLATILE,
+			KEY_NOTIFY, NULL, &hKey, NULL) != ERROR_SUCCESS) {
+			SpoutLogWarning("CCamSettingsService::Watch - could not open registry key");
+			hKey = NULL;
+		}
+	}
+
+	bool bWatching = false;
+	if (hKey) {
+		bWatching = (RegNotifyChangeKeyValue(hKey, FALSE, REG_NOTIFY_CHANGE_LAST_SET, hChange, TRUE) == ERROR_SUCCESS);
+		// The key may have changed before the notification was made
+		if (bWatching)
+			Reload();
+	}
+
+	HANDLE handles[3] = { m_hStop, m_hWrite, hChange };
+	bool bRunning = true;
+	while (bRunning) {
+		DWORD dwWait = WaitForMultipleObjects(bWatching ? 3 : 2, handles, FALSE, INFINITE);
+		switch (dwWait) {
+			case WAIT_OBJECT_0 + 2 :
+				bWatching = (RegNotifyChangeKeyValue(hKey, FALSE, REG_NOTIFY_CHANGE_LAST_SET, hChange, TRUE) == ERROR_SUCCESS);
+				Reload();
+				break;
+			case WAIT_OBJECT_0 + 1 :
+				break;
+			default :
+				// Stop or wait failure
+				bRunning = false;
+				break;
+		}
+
+		// Sender name write on change or before the thread exits
+		char name[256]{};
+		{
+			std::lock_guard<std::mutex> lock(m_WriteLock);
+			if (m_SenderName[0]) {
+				strcpy_s(name, 256, m_SenderName);
+				m_SenderName[0] = 0;
+			}
+		}
+		if (name[0])
+			WritePathToRegistry(HKEY_CURRENT_USER, m_Key, "sendername", name);
+	}
+
+	if (hKey) RegCloseKey(hKey);
+	if (hChange) CloseHandle(hChange);
+}
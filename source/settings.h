@@ -0,0 +1,100 @@
+//
+//		SpoutCam - settings.h
+//
+//	Settings service
+//
+//	The SpoutCam registry settings are loaded once into a snapshot that is
+//	not changed after that. A watcher thread waits for change of the registry
+//	key and replaces the snapshot with a new one. The streaming thread checks
+//	the snapshot version for each frame and applies changes that do not
+//	require a new media type. Registry writes are made by the watcher thread.
+//
+//	19.10.26 - Create file
+//
+
+#pragma once
+
+#include <windows.h>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+// Registry key for SpoutCam settings
+#define SPOUTCAM_REGISTRY_KEY "Software\\Leading Edge\\SpoutCam"
+
+//
+// Settings snapshot
+//
+// Registry values written by SpoutCamSettings or the properties dialog.
+// Fps and resolution require the filter to be re-started.
+// All other settings are applied while the filter is running.
+//
+struct CamSettings {
+	DWORD dwFps;            // Fps index (default 3 = 30 fps)
+	DWORD dwResolution;     // Resolution index (default 0 = active sender)
+	DWORD dwMirror;         // Mirror image
+	DWORD dwSwap;           // RGB <> BGR
+	DWORD dwFlip;           // Flip image
+	DWORD dwRotation;       // Clockwise rotation degrees (0, 90, 180, 270)
+	DWORD dwFrameWait;      // Wait for a new sender frame
+	DWORD dwTiming;         // Timing probes
+	DWORD dwFrameShare;     // Share converted frames with other processes
+	DWORD dwChangeDetect;   // Convert only rows changed since the last frame
+	DWORD dwFitMode;        // Fit of a sender of different aspect ratio (0 stretch, 1 letterbox, 2 crop)
+	DWORD dwBorderColour;   // Letterbox border colour (0xRRGGBB)
+	DWORD dwRegionX;        // Region of the sender to receive
+	DWORD dwRegionY;        // (zero width or height for the whole sender)
+	DWORD dwRegionWidth;
+	DWORD dwRegionHeight;
+	DWORD dwToneMap;        // Tone mapping of half float senders (0 none, 1 Reinhard, 2 ACES)
+	DWORD dwExposure;       // Tone mapping exposure percent (0 or 100 = 1.0)
+	DWORD dwBrightness;     // Colour adjustment brightness percent (signed, 0 = none)
+	DWORD dwContrast;       // Contrast percent (0 or 100 = none)
+	DWORD dwGamma;          // Gamma x 100 (0 or 100 = none)
+	DWORD dwSaturation;     // Saturation percent (0 or 100 = none)
+	DWORD dwBlackLevel;     // Input black level (0 - 255)
+	DWORD dwWhiteLevel;     // Input white level (0 or 255 = none)
+	DWORD dwStaticMode;     // Static image (0 noise for each frame, 1 pool of noise frames)
+	DWORD dwPattern;        // Test pattern instead of static (0 none, 1 bars, 2 ramp, 3 sweep)
+	DWORD dwTimecode;       // Timecode watermark (0 none, 1 default cell size, >1 cell size in pixels)
+	char senderstart[256];  // Starting sender name
+};
+
+class CCamSettingsService
+{
+
+public:
+
+	CCamSettingsService();
+	~CCamSettingsService();
+
+	// Load settings from the registry and start watching for changes
+	bool Start(const char* key = SPOUTCAM_REGISTRY_KEY);
+	// Stop watching for changes
+	void Stop();
+	// The current settings snapshot
+	std::shared_ptr<const CamSettings> Get() const;
+	// Incremented for each new snapshot
+	LONG GetVersion() const;
+	// Write the received sender name to the registry for SpoutCamSettings
+	void WriteSenderName(const char* name);
+
+private:
+
+	void Load(CamSettings& settings);
+	void Reload();
+	void Watch();
+
+	char m_Key[256];
+	std::shared_ptr<const CamSettings> m_pSettings;
+	std::atomic<LONG> m_Version;
+
+	std::thread m_Thread;
+	HANDLE m_hStop;        // Stop the watcher thread
+	HANDLE m_hWrite;       // Registry write requested
+
+	std::mutex m_WriteLock;
+	char m_SenderName[256]; // Sender name waiting to be written
+
+};
@@ -0,0 +1,254 @@
+//
+//		SpoutBufferBench.cpp
+//
+//	Compare the spoutCopy buffer utilities with the row by row
+//	versions they replaced :
+//
+//	  FlipBuffer in place - rows swapped in registers,
+//	                        previously through an allocated row
+//	  RemovePadding       - memcpy for unaligned rows,
+//	                        previously __movsd
+//	  ClearAlpha          - masked alpha fill,
+//	                        previously one byte per pixel
+//
+//	Usage :
+//
+//	  SpoutBufferBench [options]
+//
+//	  -w width      image width (default 1920)
+//	  -h height     image height (default 1080)
+//	  -p padding    RemovePadding bytes at the end of each source row (default 12)
+//	  -n frames     frames timed for each function (default 100)
+//
+//	The functions are first checked against the previous versions for
+//	a range of sizes, formats and buffer alignments, and the program
+//	returns 1 if any result differs.
+//
+//	On other systems __movsd is memcpy (see compat\windows.h), so the
+//	previous RemovePadding is compared with the library memcpy there.
+//
+//	To build (x86 or x64) :
+//
+//	  cl /EHsc /O2 /I..\..\SpoutDX\source SpoutBufferBench.cpp SpoutCopyTool.cpp
+//	  g++ -std=c++11 -O2 -mssse3 -mxsave -Icompat -I../../SpoutDX/source SpoutBufferBench.cpp SpoutCopyTool.cpp -o SpoutBufferBench
+//
+//	19.10.26 - Create file
+//
+
+#include "SpoutCopyTool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+static unsigned int g_Seed = 0x12345678;
+
+static void Fill(std::vector<unsigned char>& buffer)
+{
+	for (unsigned char& c : buffer) {
+		g_Seed = g_Seed*1664525u + 1013904223u;
+		c = static_cast<unsigned char>(g_Seed >> 24);
+	}
+}
+
+static unsigned int BytesPerPixel(GLenum glFormat)
+{
+	if (glFormat == GL_LUMINANCE)
+		return 1;
+	if (glFormat == GL_RGB || glFormat == GL_BGR_EXT)
+		return 3;
+	return 4;
+}
+
+//
+// Previous versions
+//
+
+static void FlipPrevious(unsigned char* src, unsigned int width, unsigned int height, GLenum glFormat)
+{
+	const unsigned int pitch = width*BytesPerPixel(glFormat);
+	unsigned char* tempRow = new unsigned char[pitch];
+	for (unsigned int y = 0; y < height/2; y++) {
+		unsigned char* rowTop = src + y*pitch;
+		unsigned char* rowBottom = src + (height - 1 - y)*pitch;
+		memcpy(tempRow, rowTop, pitch);
+		memcpy(rowTop, rowBottom, pitch);
+		memcpy(rowBottom, tempRow, pitch);
+	}
+	delete[] tempRow;
+}
+
+static void RemovePaddingPrevious(const spoutCopy& copy, const unsigned char* source, unsigned char* dest,
+	unsigned int width, unsigned int height, unsigned int stride, GLenum glFormat, bool bSSE2)
+{
+	const unsigned int pitch = width*BytesPerPixel(glFormat);
+	for (unsigned int y = 0; y < height; y++) {
+		if (pitch < 320 || stride < 320)
+			memcpy(dest, source, pitch);
+		else if ((pitch % 16) == 0 && (stride % 16) == 0 && bSSE2)
+			copy.memcpy_sse2(dest, source, pitch);
+		else if ((pitch % 4) == 0 && (stride % 4) == 0)
+			__movsd(reinterpret_cast<unsigned long *>(dest), reinterpret_cast<const unsigned long *>(source), pitch/4);
+		else
+			memcpy(dest, source, pitch);
+		source += stride;
+		dest += pitch;
+	}
+}
+
+static void ClearAlphaPrevious(unsigned char* src, unsigned int width, unsigned int height, unsigned char alpha)
+{
+	unsigned char* pixels = src;
+	for (unsigned int i = 0; i < width*height; i++) {
+		*(pixels + 3) = alpha;
+		pixels += 4;
+	}
+}
+
+//
+// Check against the previous versions
+//
+static int Check(spoutCopy& copy, bool bSSE2)
+{
+	int failed = 0;
+	const unsigned int widths[] = { 1, 3, 5, 16, 17, 100, 333, 640 };
+	const unsigned int heights[] = { 1, 2, 3, 7, 64 };
+	const GLenum formats[] = { GL_RGBA, GL_RGB, GL_LUMINANCE };
+
+	for (unsigned int width : widths) {
+		for (unsigned int height : heights) {
+			for (GLenum glFormat : formats) {
+				// Buffer offsets for alignment, with guard bytes each side
+				for (unsigned int offset = 0; offset < 4; offset++) {
+					const unsigned int pitch = width*BytesPerPixel(glFormat);
+					const size_t size = static_cast<size_t>(pitch)*height;
+
+					std::vector<unsigned char> buffer(size + 8);
+					Fill(buffer);
+					std::vector<unsigned char> expected(buffer);
+					copy.FlipBuffer(buffer.data() + offset, width, height, glFormat);
+					FlipPrevious(expected.data() + offset, width, height, glFormat);
+					if (buffer != expected) {
+						printf("FlipBuffer differs : %u x %u, bpp %u, offset %u\n",
+							width, height, BytesPerPixel(glFormat), offset);
+						failed++;
+					}
+
+					if (glFormat != GL_LUMINANCE) {
+						const unsigned int stride = pitch + offset*5 + width%7;
+						std::vector<unsigned char> source(static_cast<size_t>(stride)*height + 8);
+						Fill(source);
+						std::vector<unsigned char> dest(size + 8, 0xAB);
+						std::vector<unsigned char> previous(dest);
+						copy.RemovePadding(source.data() + offset, dest.data() + 1, width, height, stride, glFormat);
+						RemovePaddingPrevious(copy, source.data() + offset, previous.data() + 1,
+							width, height, stride, glFormat, bSSE2);
+						if (dest != previous) {
+							printf("RemovePadding differs : %u x %u, bpp %u, stride %u\n",
+								width, height, BytesPerPixel(glFormat), stride);
+							failed++;
+						}
+					}
+
+					if (glFormat == GL_RGBA) {
+						Fill(buffer);
+						expected = buffer;
+						copy.ClearAlpha(buffer.data() + offset, width, height, 77);
+						ClearAlphaPrevious(expected.data() + offset, width, height, 77);
+						if (buffer != expected) {
+							printf("ClearAlpha differs : %u x %u, offset %u\n", width, height, offset);
+							failed++;
+						}
+					}
+				}
+			}
+		}
+	}
+	return failed;
+}
+
+//
+// Time a function over a number of frames
+//
+template <typename Function>
+static void Time(const char* name, int frames, double megabytes, Function function)
+{
+	function(); // first use of the buffers
+	double best = 1.0e9;
+	double sum = 0.0;
+	for (int i = 0; i < frames; i++) {
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		const double msec = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		best = std::min(best, msec);
+		sum += msec;
+	}
+	printf("  %-10s %.3f ms (min %.3f)  %.0f MB/s\n", name, sum/frames, best, megabytes*1000.0*frames/sum);
+}
+
+static void Usage()
+{
+	printf("SpoutBufferBench [-w width] [-h height] [-p padding] [-n frames]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int width = 1920;
+	unsigned int height = 1080;
+	unsigned int padding = 12;
+	int frames = 100;
+
+	for (int i = 1; i < argc; i++) {
+		const bool bValue = (i + 1 < argc);
+		if (strcmp(argv[i], "-w") == 0 && bValue)
+			width = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-h") == 0 && bValue)
+			height = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-p") == 0 && bValue)
+			padding = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-n") == 0 && bValue)
+			frames = atoi(argv[++i]);
+		else {
+			Usage();
+			return 1;
+		}
+	}
+	if (width == 0 || height == 0 || frames <= 0) {
+		Usage();
+		return 1;
+	}
+
+	spoutCopy copy;
+	const bool bSSE2 = copy.GetSSE2();
+
+	const int failed = Check(copy, bSSE2);
+	printf("Check : %s\n", failed ? "FAILED" : "same as the previous versions");
+
+	const unsigned int pitch = width*4;
+	const unsigned int stride = pitch + padding;
+	const double megabytes = static_cast<double>(pitch)*height/1000000.0;
+	std::vector<unsigned char> image(static_cast<size_t>(pitch)*height);
+	std::vector<unsigned char> source(static_cast<size_t>(stride)*height);
+	Fill(image);
+	Fill(source);
+
+	printf("%u x %u rgba, %d frames\n", width, height, frames);
+
+	printf("FlipBuffer in place\n");
+	Time("current", frames, megabytes, [&] { copy.FlipBuffer(image.data(), width, height, GL_RGBA); });
+	Time("previous", frames, megabytes, [&] { FlipPrevious(image.data(), width, height, GL_RGBA); });
+
+	printf("RemovePadding, source stride %u\n", stride);
+	Time("current", frames, megabytes, [&] {
+		copy.RemovePadding(source.data(), image.data(), width, height, stride, GL_RGBA); });
+	Time("previous", frames, megabytes, [&] {
+		RemovePaddingPrevious(copy, source.data(), image.data(), width, height, stride, GL_RGBA, bSSE2); });
+
+	printf("ClearAlpha\n");
+	Time("current", frames, megabytes, [&] { copy.ClearAlpha(image.data(), width, height, 0xFF); });
+	Time("previous", frames, megabytes, [&] { ClearAlphaPrevious(image.data(), width, height, 0xFF); });
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,10 @@
+//
+//		SpoutCopyTool.cpp
+//
+//	SpoutCopy.cpp compiled for the tools (see SpoutCopyTool.h)
+//
+//	19.10.26 - Create file
+//
+
+#include "SpoutCopyTool.h"
+#include "SpoutCopy.cpp"
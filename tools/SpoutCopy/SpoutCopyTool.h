@@ -0,0 +1,20 @@
+//
+//		SpoutCopyTool.h
+//
+//	spoutCopy for the tools, without the rest of the Spout library.
+//
+//	SpoutCommon.h includes SpoutUtils.h, which needs Windows. On other
+//	systems its guard and the export definition are set here instead and
+//	the "compat" folder has the few Windows, OpenGL and intrinsic
+//	definitions that SpoutCopy uses. Add it to the include path.
+//
+//	19.10.26 - Create file
+//
+#pragma once
+
+#ifndef _WIN32
+#define __SpoutCommon__
+#define SPOUT_DLLEXP
+#endif
+
+#include "SpoutCopy.h"
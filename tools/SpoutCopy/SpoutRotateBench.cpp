@@ -0,0 +1,175 @@
+//
+//		SpoutRotateBench.cpp
+//
+//	Compare spoutCopy::rotate2rgba with a straightforward per-pixel loop
+//	for 90, 180 and 270 degree rotation of a bgra frame to rgb or rgba.
+//
+//	Usage :
+//
+//	  SpoutRotateBench [options]
+//
+//	  -w width      source width (default 1080)
+//	  -h height     source height (default 1920)
+//	  -n frames     frames timed for each rotation (default 20)
+//	  -a            rgba destination instead of rgb
+//	  -b band       destination rows for each rotate2rgba call
+//	                (default all, as for a single thread)
+//
+//	The default is a portrait 1080p sender rotated to a landscape
+//	camera frame. The output of both is compared and the program
+//	returns 1 if they differ.
+//
+//	To build (x86 or x64) :
+//
+//	  cl /EHsc /O2 /I..\..\SpoutDX\source SpoutRotateBench.cpp SpoutCopyTool.cpp
+//	  g++ -std=c++11 -O2 -mssse3 -mxsave -Icompat -I../../SpoutDX/source SpoutRotateBench.cpp SpoutCopyTool.cpp -o SpoutRotateBench
+//
+//	19.10.26 - Create file
+//
+
+#include "SpoutCopyTool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// DXGI_FORMAT_B8G8R8A8_UNORM
+#define FORMAT_BGRA 87
+
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Straightforward rotation, one destination pixel at a time
+static void RotateLoop(const unsigned char* source, unsigned char* dest,
+	unsigned int sourceWidth, unsigned int sourceHeight,
+	unsigned int destWidth, unsigned int destHeight, unsigned int bpp, unsigned int rotation)
+{
+	for (unsigned int y = 0; y < destHeight; y++) {
+		unsigned char* dst = dest + static_cast<size_t>(y)*destWidth*bpp;
+		for (unsigned int x = 0; x < destWidth; x++) {
+			unsigned int sx = x;
+			unsigned int sy = y;
+			if (rotation == 90) {
+				sx = y;
+				sy = sourceHeight - 1 - x;
+			}
+			else if (rotation == 180) {
+				sx = sourceWidth - 1 - x;
+				sy = sourceHeight - 1 - y;
+			}
+			else if (rotation == 270) {
+				sx = sourceWidth - 1 - y;
+				sy = x;
+			}
+			const unsigned char* src = source + (static_cast<size_t>(sy)*sourceWidth + sx)*4;
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			if (bpp == 4)
+				dst[3] = src[3];
+			dst += bpp;
+		}
+	}
+}
+
+static void Usage()
+{
+	printf("SpoutRotateBench [-w width] [-h height] [-n frames] [-a] [-b band]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int width = 1080;
+	unsigned int height = 1920;
+	unsigned int band = 0;
+	int frames = 20;
+	bool bRGB = true;
+
+	for (int i = 1; i < argc; i++) {
+		const bool bValue = (i + 1 < argc);
+		if (strcmp(argv[i], "-w") == 0 && bValue)
+			width = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-h") == 0 && bValue)
+			height = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-n") == 0 && bValue)
+			frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-b") == 0 && bValue)
+			band = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-a") == 0)
+			bRGB = false;
+		else {
+			Usage();
+			return 1;
+		}
+	}
+	if (width == 0 || height == 0 || frames <= 0) {
+		Usage();
+		return 1;
+	}
+
+	spoutCopy copy;
+	const unsigned int bpp = bRGB ? 3 : 4;
+
+	// Random source pixels
+	std::vector<unsigned char> source(static_cast<size_t>(width)*height*4);
+	unsigned int seed = 0x12345678;
+	for (unsigned char& c : source) {
+		seed = seed*1664525u + 1013904223u;
+		c = static_cast<unsigned char>(seed >> 24);
+	}
+
+	printf("Source %u x %u bgra to %s, %d frames\n", width, height, bRGB ? "rgb" : "rgba", frames);
+
+	bool bPass = true;
+	const unsigned int rotations[] = { 90, 180, 270 };
+	for (unsigned int rotation : rotations) {
+
+		const bool bQuarter = (rotation == 90 || rotation == 270);
+		const unsigned int destWidth = bQuarter ? height : width;
+		const unsigned int destHeight = bQuarter ? width : height;
+		const unsigned int rows = (band > 0) ? band : destHeight;
+		std::vector<unsigned char> loop(static_cast<size_t>(destWidth)*destHeight*bpp);
+		std::vector<unsigned char> blocked(loop.size());
+
+		// Straightforward loop
+		double loopMin = 1.0e9;
+		double loopSum = 0.0;
+		for (int i = 0; i < frames; i++) {
+			const auto start = std::chrono::steady_clock::now();
+			RotateLoop(source.data(), loop.data(), width, height, destWidth, destHeight, bpp, rotation);
+			const double msec = Milliseconds(start);
+			loopMin = std::min(loopMin, msec);
+			loopSum += msec;
+		}
+
+		// rotate2rgba in bands of destination rows
+		double blockMin = 1.0e9;
+		double blockSum = 0.0;
+		for (int i = 0; i < frames; i++) {
+			const auto start = std::chrono::steady_clock::now();
+			for (unsigned int y0 = 0; y0 < destHeight; y0 += rows) {
+				const unsigned int y1 = std::min(y0 + rows, destHeight);
+				copy.rotate2rgba(source.data(), blocked.data(), FORMAT_BGRA,
+					width, height, width*4, destWidth, destHeight, destWidth*bpp,
+					rotation, y0, y1, bRGB, false, false, false);
+			}
+			const double msec = Milliseconds(start);
+			blockMin = std::min(blockMin, msec);
+			blockSum += msec;
+		}
+
+		const bool bSame = (loop == blocked);
+		if (!bSame)
+			bPass = false;
+
+		printf("%3u degrees : loop %.2f ms (min %.2f), rotate2rgba %.2f ms (min %.2f), %.2fx %s\n",
+			rotation, loopSum/frames, loopMin, blockSum/frames, blockMin,
+			loopSum/blockSum, bSame ? "same" : "DIFFERENT");
+	}
+
+	return bPass ? 0 : 1;
+}
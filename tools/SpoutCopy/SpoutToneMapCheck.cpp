@@ -0,0 +1,214 @@
+//
+//		SpoutToneMapCheck.cpp
+//
+//	Check the half float conversion and tone mapping of spoutCopy::format2rgba
+//	against the scalar reference spoutCopy::ToneMap for all 65536 half values.
+//
+//	Each tone mapping mode is checked for a range of exposures, with the
+//	SSE2 half float conversion and with F16C if the processor has it.
+//	The 8 bit result must be within 1 of the rounded reference and alpha
+//	must be opaque. The program returns 1 if any value is outside that.
+//
+//	The time to convert a 3840 x 2160 half float frame to rgb is then
+//	shown for each mode, for comparison with the 16.7 ms of a frame at 60 fps.
+//	The frame is converted at 3840 x 2160 and re-sampled to 1920 x 1080
+//	as for a 1080p camera. The rows are divided between threads in the
+//	same way as the row scheduler of the camera (format2rgba with rows
+//	y0 - y1), so the time is for the processors of this machine.
+//
+//	Usage :
+//
+//	  SpoutToneMapCheck [-n frames] [-t threads]
+//
+//	  -n frames     frames timed for each mode (default 10, 0 for none)
+//	  -t threads    threads for the timing (default one for each processor)
+//
+//	To build (x86 or x64) :
+//
+//	  cl /EHsc /O2 /I..\..\SpoutDX\source SpoutToneMapCheck.cpp SpoutCopyTool.cpp
+//	  g++ -std=c++11 -O2 -mssse3 -mxsave -Icompat -I../../SpoutDX/source SpoutToneMapCheck.cpp SpoutCopyTool.cpp -o SpoutToneMapCheck -pthread
+//
+//	19.10.26 - Create file
+//
+
+#include "SpoutCopyTool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+// DXGI_FORMAT_R16G16B16A16_FLOAT
+#define FORMAT_HALF 10
+
+// Half float 1.0
+#define HALF_ONE 0x3C00
+
+// Selects the half float conversion
+class ToneMapCopy : public spoutCopy {
+	public:
+	bool GetF16C() const { return m_bF16C; }
+	void SetF16C(bool bF16C) { m_bF16C = bF16C; }
+};
+
+// Half float to float, independent of the conversion checked
+static float HalfToFloat(uint16_t half)
+{
+	const int sign = half >> 15;
+	const int exponent = (half >> 10) & 31;
+	const int mantissa = half & 1023;
+	float value = 0.0f;
+	if (exponent == 0)
+		value = std::ldexp(static_cast<float>(mantissa), -24);
+	else if (exponent == 31)
+		value = mantissa ? NAN : INFINITY;
+	else
+		value = std::ldexp(static_cast<float>(mantissa | 1024), exponent - 25);
+	return sign ? -value : value;
+}
+
+static const char* ModeName(int mode)
+{
+	if (mode == SPOUT_TONEMAP_REINHARD)
+		return "Reinhard";
+	if (mode == SPOUT_TONEMAP_ACES)
+		return "ACES";
+	return "None";
+}
+
+//
+// Check all half values for a mode and exposure
+// Returns the number of failures and adds values off by one
+//
+static int Check(ToneMapCopy& copy, int mode, float exposure, int &offbyone)
+{
+	int failed = 0;
+	copy.SetToneMapping(mode, exposure);
+
+	// 4 pixels for the vector conversion, each value in the colour
+	// components of every pixel with a different value in each component
+	uint16_t pixels[16];
+	unsigned char dest[16];
+	for (uint32_t value = 0; value < 65536; value++) {
+		for (int i = 0; i < 16; i++) {
+			const int component = i%4;
+			if (component == 3)
+				pixels[i] = HALF_ONE;
+			else
+				pixels[i] = static_cast<uint16_t>(value + static_cast<uint32_t>(component*(i/4 + 1)));
+		}
+		copy.format2rgba(pixels, dest, FORMAT_HALF, 4, 1, 32, 4, 1, 16, false, false, false, false);
+
+		for (int i = 0; i < 16; i++) {
+			int expected = 255;
+			if (i%4 != 3) {
+				const float reference = copy.ToneMap(HalfToFloat(pixels[i]));
+				expected = static_cast<int>(std::nearbyint(reference*255.0f));
+			}
+			const int error = abs(static_cast<int>(dest[i]) - expected);
+			if (error == 1 && i%4 != 3)
+				offbyone++;
+			else if (error > 0) {
+				if (failed < 5)
+					printf("  %s, exposure %g, half 0x%04X : %d, reference %d\n",
+						ModeName(mode), exposure, pixels[i], dest[i], expected);
+				failed++;
+			}
+		}
+	}
+	return failed;
+}
+
+//
+// Convert a frame with the rows divided between threads
+//
+static void ConvertFrame(const ToneMapCopy& copy, const uint16_t* source, unsigned char* dest,
+	unsigned int width, unsigned int height, unsigned int destWidth, unsigned int destHeight,
+	unsigned int threads)
+{
+	std::vector<std::thread> workers;
+	const unsigned int rows = (destHeight + threads - 1)/threads;
+	for (unsigned int y0 = rows; y0 < destHeight; y0 += rows) {
+		const unsigned int y1 = (y0 + rows < destHeight) ? (y0 + rows) : destHeight;
+		workers.emplace_back([&copy, source, dest, width, height, destWidth, destHeight, y0, y1] {
+			copy.format2rgba(source, dest, FORMAT_HALF, width, height, width*8,
+				destWidth, destHeight, destWidth*3, y0, y1, true, true, false, false);
+		});
+	}
+	// The first band on this thread
+	copy.format2rgba(source, dest, FORMAT_HALF, width, height, width*8,
+		destWidth, destHeight, destWidth*3, 0, rows, true, true, false, false);
+	for (std::thread& worker : workers)
+		worker.join();
+}
+
+static void Usage()
+{
+	printf("SpoutToneMapCheck [-n frames] [-t threads]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	int frames = 10;
+	unsigned int threads = std::thread::hardware_concurrency();
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			threads = static_cast<unsigned int>(atoi(argv[++i]));
+		else {
+			Usage();
+			return 1;
+		}
+	}
+
+	ToneMapCopy copy;
+	const bool bF16C = copy.GetF16C();
+	printf("F16C %s\n", bF16C ? "available" : "not available");
+
+	const float exposures[] = { 1.0f, 0.25f, 2.0f, 7.5f };
+	int failed = 0;
+	for (int f16c = 0; f16c < (bF16C ? 2 : 1); f16c++) {
+		copy.SetF16C(f16c != 0);
+		for (int mode = SPOUT_TONEMAP_NONE; mode <= SPOUT_TONEMAP_ACES; mode++) {
+			int modefailed = 0;
+			int offbyone = 0;
+			for (float exposure : exposures)
+				modefailed += Check(copy, mode, exposure, offbyone);
+			printf("%s %-8s : %s, off by one %d of %d\n", f16c ? "F16C" : "SSE2", ModeName(mode),
+				modefailed ? "FAILED" : "pass", offbyone, 65536*12*static_cast<int>(sizeof(exposures)/sizeof(float)));
+			failed += modefailed;
+		}
+	}
+	copy.SetF16C(bF16C);
+
+	if (threads == 0)
+		threads = 1;
+
+	if (frames > 0) {
+		// 4K half float frame to rgb, values around 0.1 to 2.5
+		const unsigned int width = 3840;
+		const unsigned int height = 2160;
+		std::vector<uint16_t> source(static_cast<size_t>(width)*height*4);
+		for (size_t i = 0; i < source.size(); i++)
+			source[i] = static_cast<uint16_t>(0x3000 + (i*7919)%0x1800);
+		std::vector<unsigned char> dest(static_cast<size_t>(width)*height*3);
+		printf("%u thread%s\n", threads, threads > 1 ? "s" : "");
+		const unsigned int sizes[2][2] = { { width, height }, { 1920, 1080 } };
+		for (const auto& size : sizes) {
+			for (int mode = SPOUT_TONEMAP_NONE; mode <= SPOUT_TONEMAP_ACES; mode++) {
+				copy.SetToneMapping(mode, 1.5f);
+				const auto start = std::chrono::steady_clock::now();
+				for (int i = 0; i < frames; i++)
+					ConvertFrame(copy, source.data(), dest.data(), width, height, size[0], size[1], threads);
+				const double msec = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()/frames;
+				printf("%u x %u to %u x %u %-8s : %.2f ms per frame, %s 60 fps\n", width, height,
+					size[0], size[1], ModeName(mode), msec, (msec < 1000.0/60.0) ? "within" : "over");
+			}
+		}
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,17 @@
+//
+//		gl.h
+//
+//	The OpenGL format definitions used by SpoutCopy, for building
+//	the tools on systems without the Windows OpenGL header.
+//
+//	19.10.26 - Create file
+//
+#pragma once
+
+typedef unsigned int GLenum;
+
+#define GL_RGBA      0x1908
+#define GL_RGB       0x1907
+#define GL_LUMINANCE 0x1909
+#define GL_BGR_EXT   0x80E0
+#define GL_BGRA_EXT  0x80E1
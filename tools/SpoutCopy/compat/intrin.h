@@ -0,0 +1,11 @@
+//
+//		intrin.h
+//
+//	Compiler intrinsics for building the tools with gcc or clang.
+//	_xgetbv needs -mxsave.
+//
+//	19.10.26 - Create file
+//
+#pragma once
+
+#include <x86intrin.h>
@@ -0,0 +1,37 @@
+//
+//		windows.h
+//
+//	The Windows definitions used by SpoutCopy, for building the
+//	tools on other systems with gcc or clang (x86 and x64 only).
+//
+//	19.10.26 - Create file
+//
+#pragma once
+
+// Included by windows.h with Visual Studio
+#include <cstring>
+#include <cstddef>
+#include <utility>
+
+typedef unsigned long DWORD;
+
+#ifndef __int32
+#define __int32 int
+#endif
+
+// Copy doublewords
+inline void __movsd(unsigned long* dest, const unsigned long* source, size_t count)
+{
+	memcpy(dest, source, count*4);
+}
+
+// Processor information
+inline void __cpuid(int* info, int function)
+{
+	unsigned int a, b, c, d;
+	__asm__ __volatile__("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(function), "c"(0));
+	info[0] = static_cast<int>(a);
+	info[1] = static_cast<int>(b);
+	info[2] = static_cast<int>(c);
+	info[3] = static_cast<int>(d);
+}
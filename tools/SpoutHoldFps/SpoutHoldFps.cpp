@@ -0,0 +1,275 @@
+//
+//		SpoutHoldFps.cpp
+//
+//	Measure the frame interval jitter of the HoldFps deadline timing
+//	(SpoutDX\source\SpoutFramePacer.h) at 60 and 120 fps.
+//
+//	Usage :
+//
+//	  SpoutHoldFps [options]
+//
+//	  -n frames     frames for each frame rate (default 600)
+//	  -f fps        frame rate to test, may be repeated (default 60 and 120)
+//	  -w usec       maximum random work time for each frame (default 2000)
+//	  -l usec       jitter limit for the 99th percentile (default 100)
+//	  -p usec       fixed spin time before the deadline
+//	                (default adapted to the sleep, from SPOUT_HOLD_SPIN)
+//	  -s            simulated clock instead of the system clock
+//	  -o usec       simulated sleep overshoot, maximum (default 400)
+//
+//	The system clock uses std::chrono::steady_clock and the sleep
+//	function std::this_thread::sleep_for. Each frame does a random amount
+//	of work before waiting, as an application would. The deviation of each
+//	frame interval from the period is reported and the program returns
+//	1 if the 99th percentile is over the limit.
+//
+//	The simulated clock advances only when the pacer sleeps or spins
+//	and each sleep returns late by a random time up to the overshoot,
+//	so the timing can be checked for any sleep precision without
+//	depending on the system. The deviation is zero while the overshoot
+//	is less than the spin time.
+//
+//	By default the spin time is adapted to the late return of the sleep
+//	(SpoutPacerAdapt), starting from SPOUT_HOLD_SPIN. A Linux sleep can
+//	return later than the 500 microseconds used with the high resolution
+//	timer of Windows, so on other systems the spin time starts from 2000
+//	microseconds. The first second of each frame rate is not measured
+//	while the spin time adapts. A fixed spin time (-p) shows the jitter
+//	without adapting.
+//
+//	The file has no Windows dependency. To build :
+//
+//	  cl /EHsc /O2 /I..\..\SpoutDX\source SpoutHoldFps.cpp
+//	  g++ -std=c++11 -O2 -I../../SpoutDX/source SpoutHoldFps.cpp -o SpoutHoldFps -pthread
+//
+//	19.10.26 - Create file
+//
+
+// A sleep on other systems can return later than the high resolution
+// timer used on Windows, so the spin time starts higher
+#ifndef _WIN32
+#define SPOUT_HOLD_SPIN 2000.0
+#endif
+
+#include "SpoutFramePacer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <immintrin.h>
+#define SPIN_PAUSE() _mm_pause()
+#else
+#define SPIN_PAUSE()
+#endif
+
+// Random numbers for the work and overshoot times
+static uint32_t g_Random = 0x12345678;
+
+static double Random(double maximum)
+{
+	// xorshift32
+	g_Random ^= g_Random << 13;
+	g_Random ^= g_Random >> 17;
+	g_Random ^= g_Random << 5;
+	return maximum*static_cast<double>(g_Random)/4294967296.0;
+}
+
+//
+// System clock
+//
+
+static double SystemNow(void* user)
+{
+	(void)user;
+	return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count())/1000.0;
+}
+
+static void SystemSleep(void* user, double usec)
+{
+	(void)user;
+	std::this_thread::sleep_for(std::chrono::microseconds(static_cast<long long>(usec)));
+}
+
+static void SystemSpin(void* user)
+{
+	(void)user;
+	SPIN_PAUSE();
+}
+
+//
+// Simulated clock
+//
+
+struct SimClock {
+	double now;       // microseconds
+	double overshoot; // maximum late return of a sleep
+};
+
+static double SimNow(void* user)
+{
+	return static_cast<SimClock*>(user)->now;
+}
+
+static void SimSleep(void* user, double usec)
+{
+	SimClock* sim = static_cast<SimClock*>(user);
+	sim->now += usec + Random(sim->overshoot);
+}
+
+static void SimSpin(void* user)
+{
+	static_cast<SimClock*>(user)->now += 0.05;
+}
+
+// Work for a time before waiting for the frame
+static void Work(const SpoutPacerClock& clock, double usec)
+{
+	if (clock.now == SimNow) {
+		static_cast<SimClock*>(clock.user)->now += usec;
+		return;
+	}
+	const double end = clock.now(clock.user) + usec;
+	while (clock.now(clock.user) < end)
+		SPIN_PAUSE();
+}
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+	const size_t i = static_cast<size_t>(p*static_cast<double>(sorted.size() - 1) + 0.5);
+	return sorted[std::min(i, sorted.size() - 1)];
+}
+
+// Run one frame rate and return the 99th percentile deviation
+// A spin time of zero is adapted to the sleep.
+static double Run(int fps, int frames, double work, double fixedspin, const SpoutPacerClock& clock)
+{
+	const bool bAdapt = (fixedspin <= 0.0);
+	double spin = bAdapt ? SPOUT_HOLD_SPIN : fixedspin;
+	double maxspin = spin;
+	const double period = SpoutPacerPeriod(fps);
+	double deadline = SpoutPacerStart(period, clock);
+	double last = clock.now(clock.user);
+
+	// The first second is not measured, so that the spin time
+	// can adapt to the sleep before the intervals are recorded
+	const int warmup = bAdapt ? fps : 0;
+
+	std::vector<double> deviation;
+	double sum = 0.0;
+	for (int i = 0; i <= warmup + frames; i++) {
+		Work(clock, Random(work));
+		double overshoot = -1.0;
+		deadline = SpoutPacerHold(deadline, period, clock, spin, &overshoot);
+		if (bAdapt) {
+			spin = SpoutPacerAdapt(spin, overshoot, period);
+			if (spin > maxspin) maxspin = spin;
+		}
+		const double now = clock.now(clock.user);
+		// The first interval is from the start of the session
+		if (i > warmup) {
+			const double value = now - last - period;
+			deviation.push_back(value < 0.0 ? -value : value);
+			sum += now - last;
+		}
+		last = now;
+	}
+
+	std::sort(deviation.begin(), deviation.end());
+	double mean = 0.0;
+	for (double v : deviation)
+		mean += v;
+	if (!deviation.empty())
+		mean /= static_cast<double>(deviation.size());
+	const double p99 = Percentile(deviation, 0.99);
+
+	printf("%3d fps : period %.1f, interval mean %.1f, deviation mean %.1f  median %.1f  99%% %.1f  max %.1f usec (%d)\n",
+		fps, period, sum/static_cast<double>(frames), mean,
+		Percentile(deviation, 0.5), p99, Percentile(deviation, 1.0), static_cast<int>(deviation.size()));
+	if (bAdapt)
+		printf("          spin adapted %.1f to %.1f usec, last %.1f\n", SPOUT_HOLD_SPIN, maxspin, spin);
+
+	return p99;
+}
+
+static void Usage()
+{
+	printf("SpoutHoldFps [-n frames] [-f fps] [-w work] [-l limit] [-p spin] [-s] [-o overshoot]\n");
+}
+
+int main(int argc, char* argv[])
+{
+	int frames = 600;
+	double work = 2000.0;
+	double limit = 100.0;
+	double spin = 0.0; // adapted
+	bool bSimulate = false;
+	SimClock sim = { 0.0, 400.0 };
+	std::vector<int> rates;
+
+	for (int i = 1; i < argc; i++) {
+		const bool bValue = (i + 1 < argc);
+		if (strcmp(argv[i], "-n") == 0 && bValue)
+			frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-f") == 0 && bValue)
+			rates.push_back(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-w") == 0 && bValue)
+			work = atof(argv[++i]);
+		else if (strcmp(argv[i], "-l") == 0 && bValue)
+			limit = atof(argv[++i]);
+		else if (strcmp(argv[i], "-p") == 0 && bValue)
+			spin = atof(argv[++i]);
+		else if (strcmp(argv[i], "-o") == 0 && bValue)
+			sim.overshoot = atof(argv[++i]);
+		else if (strcmp(argv[i], "-s") == 0)
+			bSimulate = true;
+		else {
+			Usage();
+			return 1;
+		}
+	}
+
+	if (rates.empty()) {
+		rates.push_back(60);
+		rates.push_back(120);
+	}
+	for (int fps : rates) {
+		if (fps <= 0 || frames <= 0) {
+			Usage();
+			return 1;
+		}
+	}
+
+	SpoutPacerClock clock = { SystemNow, SystemSleep, SystemSpin, nullptr };
+	if (bSimulate) {
+		clock.now = SimNow;
+		clock.sleep = SimSleep;
+		clock.spin = SimSpin;
+		clock.user = &sim;
+		printf("Simulated clock, sleep overshoot up to %.1f usec\n", sim.overshoot);
+	}
+	if (spin > 0.0)
+		printf("Spin %.1f usec, ", spin);
+	else
+		printf("Adaptive spin, ");
+	printf("work up to %.1f usec, limit %.1f usec\n", work, limit);
+
+	bool bPass = true;
+	for (int fps : rates) {
+		// Work must leave time to wait in the frame
+		const double framework = std::min(work, SpoutPacerPeriod(fps)/2.0);
+		if (Run(fps, frames, framework, spin, clock) > limit)
+			bPass = false;
+	}
+
+	printf("%s\n", bPass ? "PASS" : "FAIL");
+	return bPass ? 0 : 1;
+}
@@ -0,0 +1,317 @@
+//
+//		SpoutTimecode.cpp
+//
+//	Read the SpoutCam timecode watermark from frames saved by
+//	the receiving application and report the latency.
+//
+//	SpoutCam writes a block of cells with the sender frame number and
+//	capture time to the top left corner of each frame if the "timecode"
+//	registry option is set (see SpoutDX\source\SpoutTimecode.h).
+//	The receiving application saves the frames it receives, either as
+//	bitmap files or as raw frames one after another in a file, and
+//	records the time each frame was received in microseconds of the
+//	system performance counter, one time per line in the same order.
+//
+//	Usage :
+//
+//	  SpoutTimecode [options] file [file ...]
+//
+//	  -w width      raw frame width
+//	  -h height     raw frame height
+//	  -f format     raw frame format : rgb24, rgb32, yuy2, uyvy, nv12, i420, gray
+//	                (bgr24 and bgra are the same as rgb24 and rgb32)
+//	  -t file       receive times (microseconds), one for each frame
+//	  -c cell       cell size in pixels (default search all sizes)
+//	  -v            list each frame
+//
+//	Bitmap files (.bmp) of 24 or 32 bits are read with the size in the file.
+//	Frames are searched for the block top down and then bottom up.
+//
+//	Without receive times, the frame numbers and capture intervals are
+//	reported so that dropped and repeated frames can be seen.
+//
+//	The file has no Windows dependency. To build :
+//
+//	  cl /EHsc /O2 /I..\..\SpoutDX\source SpoutTimecode.cpp
+//	  g++ -std=c++11 -O2 -I../../SpoutDX/source SpoutTimecode.cpp -o SpoutTimecode
+//
+//	19.10.26 - Create file
+//
+
+#include "SpoutTimecode.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// Raw frame formats
+struct FrameFormat {
+	const char* name;
+	unsigned int step;     // bytes per luminance sample
+	unsigned int offset;   // byte offset of the first luminance sample
+	unsigned int channels; // 3 for RGB, 1 for luminance
+	unsigned int numerator; // frame size is width*height*numerator/denominator
+	unsigned int denominator;
+};
+
+static const FrameFormat formats[] = {
+	{ "rgb24", 3, 0, 3, 3, 1 },
+	{ "bgr24", 3, 0, 3, 3, 1 },
+	{ "rgb32", 4, 0, 3, 4, 1 },
+	{ "bgra",  4, 0, 3, 4, 1 },
+	{ "rgba",  4, 0, 3, 4, 1 },
+	{ "yuy2",  2, 0, 1, 2, 1 },
+	{ "uyvy",  2, 1, 1, 2, 1 },
+	{ "nv12",  1, 0, 1, 3, 2 },
+	{ "i420",  1, 0, 1, 3, 2 },
+	{ "gray",  1, 0, 1, 1, 1 },
+};
+
+// A decoded frame
+struct Timecode {
+	std::string source; // file and frame index
+	uint32_t frame;
+	uint64_t time;
+	unsigned int cell;
+};
+
+static void Usage()
+{
+	printf("SpoutTimecode [-w width -h height -f format] [-t times] [-c cell] [-v] file ...\n");
+	printf("  formats : rgb24, rgb32, yuy2, uyvy, nv12, i420, gray\n");
+}
+
+static bool LoadFile(const char* path, std::vector<uint8_t>& data)
+{
+	FILE* fp = fopen(path, "rb");
+	if (!fp)
+		return false;
+	fseek(fp, 0, SEEK_END);
+	const long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (size <= 0) {
+		fclose(fp);
+		return false;
+	}
+	data.resize(static_cast<size_t>(size));
+	const size_t read = fread(data.data(), 1, data.size(), fp);
+	fclose(fp);
+	return read == data.size();
+}
+
+static uint32_t ReadLE(const uint8_t* p, int bytes)
+{
+	uint32_t value = 0;
+	for (int i = 0; i < bytes; i++)
+		value |= static_cast<uint32_t>(p[i]) << (i*8);
+	return value;
+}
+
+// Search a frame top down and then bottom up
+static bool Decode(const uint8_t* data, unsigned int width, unsigned int height,
+	size_t pitch, unsigned int step, unsigned int channels,
+	unsigned int cell, Timecode& code)
+{
+	code.cell = cell;
+	if (SpoutTimecodeRead(data, width, height, static_cast<ptrdiff_t>(pitch),
+		step, channels, code.frame, code.time, code.cell))
+		return true;
+	code.cell = cell;
+	return SpoutTimecodeRead(data + (height - 1)*pitch, width, height, -static_cast<ptrdiff_t>(pitch),
+		step, channels, code.frame, code.time, code.cell);
+}
+
+// Bitmap file of 24 or 32 bits
+static bool DecodeBitmap(const std::vector<uint8_t>& file, unsigned int cell, Timecode& code)
+{
+	if (file.size() < 54 || file[0] != 'B' || file[1] != 'M')
+		return false;
+	const uint32_t offset = ReadLE(&file[10], 4);
+	const int32_t width = static_cast<int32_t>(ReadLE(&file[18], 4));
+	int32_t height = static_cast<int32_t>(ReadLE(&file[22], 4));
+	const unsigned int bits = ReadLE(&file[28], 2);
+	if (height < 0)
+		height = -height;
+	if (width <= 0 || height == 0 || (bits != 24 && bits != 32))
+		return false;
+	const size_t pitch = ((static_cast<size_t>(width)*bits/8) + 3) & ~static_cast<size_t>(3);
+	if (offset + pitch*static_cast<size_t>(height) > file.size())
+		return false;
+	return Decode(&file[offset], width, height, pitch, bits/8, 3, cell, code);
+}
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+	const size_t i = static_cast<size_t>(p*static_cast<double>(sorted.size() - 1) + 0.5);
+	return sorted[std::min(i, sorted.size() - 1)];
+}
+
+static void Report(const char* name, std::vector<double> values)
+{
+	if (values.empty())
+		return;
+	std::sort(values.begin(), values.end());
+	double sum = 0.0;
+	for (double v : values)
+		sum += v;
+	printf("%s (msec) : min %.3f  mean %.3f  median %.3f  95%% %.3f  99%% %.3f  max %.3f  (%d)\n",
+		name, values.front(), sum/static_cast<double>(values.size()),
+		Percentile(values, 0.5), Percentile(values, 0.95), Percentile(values, 0.99),
+		values.back(), static_cast<int>(values.size()));
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int width = 0;
+	unsigned int height = 0;
+	unsigned int cell = 0;
+	const FrameFormat* format = &formats[0];
+	const char* timesfile = nullptr;
+	bool bVerbose = false;
+	std::vector<const char*> files;
+
+	for (int i = 1; i < argc; i++) {
+		const bool bValue = (i + 1 < argc);
+		if (strcmp(argv[i], "-w") == 0 && bValue)
+			width = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-h") == 0 && bValue)
+			height = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-c") == 0 && bValue)
+			cell = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-t") == 0 && bValue)
+			timesfile = argv[++i];
+		else if (strcmp(argv[i], "-v") == 0)
+			bVerbose = true;
+		else if (strcmp(argv[i], "-f") == 0 && bValue) {
+			const char* name = argv[++i];
+			format = nullptr;
+			for (const FrameFormat& f : formats) {
+				if (strcmp(f.name, name) == 0)
+					format = &f;
+			}
+			if (!format) {
+				printf("Unknown format \"%s\"\n", name);
+				Usage();
+				return 1;
+			}
+		}
+		else if (argv[i][0] == '-') {
+			Usage();
+			return 1;
+		}
+		else
+			files.push_back(argv[i]);
+	}
+
+	if (files.empty()) {
+		Usage();
+		return 1;
+	}
+
+	// Receive times, one for each frame in the order read
+	std::vector<uint64_t> times;
+	if (timesfile) {
+		FILE* fp = fopen(timesfile, "r");
+		if (!fp) {
+			printf("Could not open \"%s\"\n", timesfile);
+			return 1;
+		}
+		char line[256];
+		while (fgets(line, 256, fp)) {
+			if (line[0] >= '0' && line[0] <= '9')
+				times.push_back(strtoull(line, nullptr, 10));
+		}
+		fclose(fp);
+	}
+
+	// Read all frames
+	std::vector<Timecode> codes;
+	std::vector<int> indices; // Frame index of each code for the receive time
+	int frames = 0;
+	for (const char* path : files) {
+		std::vector<uint8_t> file;
+		if (!LoadFile(path, file)) {
+			printf("Could not read \"%s\"\n", path);
+			continue;
+		}
+		Timecode code{};
+		code.source = path;
+		if (file.size() >= 2 && file[0] == 'B' && file[1] == 'M') {
+			if (DecodeBitmap(file, cell, code)) {
+				codes.push_back(code);
+				indices.push_back(frames);
+			}
+			else if (bVerbose)
+				printf("%s : no timecode\n", path);
+			frames++;
+			continue;
+		}
+		// Raw frames one after another
+		if (width == 0 || height == 0) {
+			printf("\"%s\" - raw frames need width and height\n", path);
+			continue;
+		}
+		const size_t framesize = static_cast<size_t>(width)*height*format->numerator/format->denominator;
+		const size_t pitch = static_cast<size_t>(width)*format->step;
+		for (size_t pos = 0; pos + framesize <= file.size(); pos += framesize) {
+			code.source = std::string(path) + " [" + std::to_string(pos/framesize) + "]";
+			if (Decode(&file[pos + format->offset], width, height, pitch,
+				format->step, format->channels, cell, code)) {
+				codes.push_back(code);
+				indices.push_back(frames);
+			}
+			else if (bVerbose)
+				printf("%s : no timecode\n", code.source.c_str());
+			frames++;
+		}
+	}
+
+	printf("Frames %d, timecodes %d\n", frames, static_cast<int>(codes.size()));
+	if (codes.empty())
+		return 1;
+	if (!times.empty() && static_cast<int>(times.size()) != frames)
+		printf("Receive times %d do not match the frames\n", static_cast<int>(times.size()));
+
+	// Latency, capture intervals and frame sequence
+	std::vector<double> latency;
+	std::vector<double> intervals;
+	int repeated = 0;
+	int dropped = 0;
+	for (size_t i = 0; i < codes.size(); i++) {
+		const Timecode& code = codes[i];
+		double msec = -1.0;
+		if (indices[i] < static_cast<int>(times.size())) {
+			msec = static_cast<double>(SpoutTimecodeElapsed(code.time, times[indices[i]]))/1000.0;
+			latency.push_back(msec);
+		}
+		if (i > 0) {
+			const uint32_t step = code.frame - codes[i - 1].frame;
+			if (step == 0)
+				repeated++;
+			else {
+				if (step > 1 && step < 0x80000000u)
+					dropped += static_cast<int>(step - 1);
+				intervals.push_back(static_cast<double>(SpoutTimecodeElapsed(codes[i - 1].time, code.time))/1000.0);
+			}
+		}
+		if (bVerbose) {
+			if (msec >= 0.0)
+				printf("%s : frame %u, capture %llu, cell %u, latency %.3f msec\n", code.source.c_str(),
+					code.frame, static_cast<unsigned long long>(code.time), code.cell, msec);
+			else
+				printf("%s : frame %u, capture %llu, cell %u\n", code.source.c_str(),
+					code.frame, static_cast<unsigned long long>(code.time), code.cell);
+		}
+	}
+
+	printf("Sender frames %u to %u, repeated %d, dropped %d\n",
+		codes.front().frame, codes.back().frame, repeated, dropped);
+	Report("Capture interval", intervals);
+	Report("Latency", latency);
+
+	return 0;
+}